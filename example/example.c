@@ -2,9 +2,9 @@
 
 #include "reim/analyze_ap.h"
 #include "reim/analyze_fo.h"
-#include "reim/analyze_silence.h"
 #include "reim/analyze_sp.h"
 #include "reim/audio_frame.h"
+#include "reim/frame_analyzer.h"
 #include "reim/mathematics.h"
 #include "reim/memory.h"
 #include "reim/synthesis.h"
@@ -21,11 +21,13 @@ typedef struct {
     fo_context_t* fo_context;
     ap_context_t* ap_context;
     sp_context_t* sp_context;
+    frame_analyzer_t* analyzer;
     synthesis_context_t* synthesis;
 
-    double* waveform;
-    double* ap;
-    double* sp;
+    real_t* input;
+    real_t* output;
+    real_t* ap;
+    real_t* sp;
 } audio_data_t;
 
 void* audio_initializer(size_t buffer_size, double fs)
@@ -42,9 +44,11 @@ void* audio_initializer(size_t buffer_size, double fs)
     data->fo_context = create_fo_context(data->vocoder);
     data->sp_context = create_sp_context(data->vocoder);
     data->ap_context = create_ap_context(data->vocoder);
+    data->analyzer = create_frame_analyzer(data->vocoder, data->fo_context, data->ap_context, data->sp_context, 2);
     data->synthesis = create_synthesis_context(data->vocoder);
 
-    data->waveform = allocate_vector(fftsize + 1);
+    data->input = allocate_vector(buffer_size);
+    data->output = allocate_vector(buffer_size);
     data->ap = allocate_vector(numbins);
     data->sp = allocate_vector(numbins);
 
@@ -55,6 +59,7 @@ void audio_terminator(void** userdata)
 {
     audio_data_t* data = (audio_data_t*)*userdata;
 
+    destroy_frame_analyzer(&data->analyzer);
     destroy_audio_frame(&data->frame);
     destroy_vocoder_context(&data->vocoder);
     destroy_fo_context(&data->fo_context);
@@ -62,7 +67,8 @@ void audio_terminator(void** userdata)
     destroy_sp_context(&data->sp_context);
     destroy_synthesis_context(&data->synthesis);
 
-    free_vector(data->waveform);
+    free_vector(data->input);
+    free_vector(data->output);
     free_vector(data->ap);
     free_vector(data->sp);
 
@@ -74,29 +80,38 @@ void audio_callback(const double* input, double* output, size_t buffer_size, voi
 {
     audio_data_t* data = (audio_data_t*)userdata;
 
-    const double* waveform = data->waveform + 1;
-    const double* waveform_delayed = data->waveform;
     for (size_t i = 0; i < buffer_size; i++) {
-        // frame analysis and synthesis
-        if (next_audio_frame(data->frame, input[i], data->waveform)) {
-            // silence analysis
-            const bool issilence = analyze_silence(data->vocoder, waveform, REIM_SILENCE_THRESHOLD);
+        data->input[i] = input[i];
+    }
 
-            // fo analysis
-            const double fo = analyze_fo(data->vocoder, data->fo_context, waveform, waveform_delayed);
+    size_t position = 0;
+    while (position < buffer_size) {
+        bool has_new_frame = false;
+        const size_t count = next_audio_frame_block(data->frame, data->input + position, buffer_size - position, &has_new_frame);
 
-            // ap analysis
-            const bool isvoiced = analyze_ap(data->vocoder, data->ap_context, waveform, fo, issilence, data->ap);
+        // synthesis: until the new frame
+        synthesize_block(data->vocoder, data->synthesis, data->output + position, count - 1);
+
+        // frame analysis and synthesis
+        if (has_new_frame) {
+            const real_t* waveform = get_audio_frame(data->frame) + 1;
+            const real_t* waveform_delayed = get_audio_frame(data->frame);
 
-            // sp analysis
-            analyze_sp(data->vocoder, data->sp_context, waveform, fo, isvoiced, issilence, data->sp);
+            // silence, fo, ap and sp analysis (sp in the log domain) on the workers
+            analyze_frame_log(data->analyzer, waveform, waveform_delayed, data->ap, data->sp);
+            const bool issilence = data->analyzer->issilence;
+            const double fo = data->analyzer->fo;
+            const bool isvoiced = data->analyzer->isvoiced;
 
             // synthesis: new frame
-            synthesize_new_frame(data->vocoder, data->synthesis, fo, isvoiced, issilence, data->ap, data->sp);
+            synthesize_new_frame_log(data->vocoder, data->synthesis, fo, isvoiced, issilence, data->ap, data->sp);
         }
-        output[i] = synthesize_next_sample(data->vocoder, data->synthesis);
-        // assert(!isnan(output[i]));
-        // assert(isfinite(output[i]));
+        synthesize_block(data->vocoder, data->synthesis, data->output + position + count - 1, 1);
+        position += count;
+    }
+
+    for (size_t i = 0; i < buffer_size; i++) {
+        output[i] = data->output[i];
     }
 }
 
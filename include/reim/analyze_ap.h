@@ -7,8 +7,8 @@ REIM_BEGIN_EXTERN_C
 #include <stddef.h>
 
 typedef struct {
-    double* x_real;
-    double* x_imag;
+    complex_t* spec;    // spectrum (also used for the windowed waveform in-place)
+    complex_t* scratch; // scratch of the transforms of the vocoder
 } ap_context_t;
 
 // Create a new aperiodicity context
@@ -19,7 +19,7 @@ void destroy_ap_context(ap_context_t** context);
 
 // Analyze aperiodicity
 // Return true for voiced frame
-bool analyze_ap(vocoder_context_t* vocoder, ap_context_t* context, const double* input, double fo, bool issilence, double* ap);
+bool analyze_ap(vocoder_context_t* vocoder, ap_context_t* context, const real_t* input, double fo, bool issilence, real_t* ap);
 
 REIM_END_EXTERN_C
 #endif
@@ -2,33 +2,71 @@
 #define __REIM_ANALYZE_FO_H__
 #include "reim/defines.h"
 REIM_BEGIN_EXTERN_C
+#include "reim/decimator.h"
 #include "reim/vocoder.h"
+#include "reim/worker_pool.h"
 #include <stdbool.h>
 #include <stddef.h>
 
+// Band-limited channel of DIO, and the streaming DIO (internal to analyze_fo.c)
+typedef struct fo_channel fo_channel_t;
+typedef struct fo_stream fo_stream_t;
+
 typedef struct {
-    size_t num_candidates;    // number of candidates
-    double** channel_filters; // filter bank for DIO
-    size_t* channel_offsets;  // sample offsets of channels
-    double* window;           // analysis window (fixed)
-
-    double* spec_r;      // real spectrum of current frame
-    double* spec_i;      // imag spectrum of current frame
-    double* specd_r;     // real spectrum of current one-sample-delayed frame
-    double* specd_i;     // imag spectrum of current one-sample-delayed frame
-    double* pspec;       // power spectrum
-    double* ifreqf;      // instantaneous frequency (frequency domain)
-    double* spec_filt_r; // real spectrum of current frame (for filtering)
-    double* spec_filt_i; // imag spectrum of current frame (for filtering)
-    double* filtered_r;  // filtered waveform (real)
-    double* filtered_i;  // filtered waveform (imag)
+    double fs;              // sampling frequency of the analysis
+    size_t fftsize;         // FFT size of the analysis
+    size_t numbins;         // number of bins of the analysis (fftsize / 2 + 1)
+    rfft_t* rfft;           // FFT of the analysis
+    decimator_t* decimator; // anti-aliasing decimator (NULL: the analysis at the original rate)
+    real_t* frame;          // input frame starting with the one-sample-delayed sample (vocoder->fftsize + 1)
+    real_t* decimated;      // decimated frame in the same layout (fftsize + 1)
+
+    size_t num_candidates;  // number of candidates
+    fo_channel_t* channels; // filter bank for DIO (num_candidates, NULL: streaming)
+    fo_stream_t* stream;    // streaming DIO (NULL: DIO on each frame)
+    real_t* window;         // analysis window (fixed)
+
+    complex_t* spec;      // spectrum of current frame
+    complex_t* specd;     // spectrum of current one-sample-delayed frame (windowed waveform until transformed)
+    real_t* pspec;        // power spectrum
+    real_t* ifreqf;       // instantaneous frequency (frequency domain, valid where ifreqf_ready is set)
+    complex_t* spec_filt; // spectrum of current frame (for filtering, NULL: streaming)
+
+    // The instantaneous frequency is evaluated lazily at the bins the candidates touch. The FFT of the delayed frame
+    // is deferred to the first of them: it still runs on every frame with a candidate (or a previous fo), and only
+    // the frames without any skip it.
+    bool specd_ready;   // specd holds the spectrum in the current frame
+    bool* ifreqf_ready; // ifreqf[k] is evaluated in the current frame (numbins)
 
     double fo_previous; // estimated fo of previous frame
 } fo_context_t;
 
 fo_context_t* create_fo_context(vocoder_context_t* vocoder);
 void destroy_fo_context(fo_context_t** context);
-double analyze_fo(vocoder_context_t* vocoder, fo_context_t* context, const double* input, const double* input_delayed);
+double analyze_fo(vocoder_context_t* vocoder, fo_context_t* context, const real_t* input, const real_t* input_delayed);
+
+// analyze_fo() with the DIO channels on the workers of the pool (the same result)
+// Only the filtering and the zero-crossings of each channel run in parallel, the candidates are refined and chosen in order.
+// The streaming DIO has nothing left to run in parallel, so it ignores the pool.
+double analyze_fo_with_pool(vocoder_context_t* vocoder, fo_context_t* context, const real_t* input, const real_t* input_delayed, worker_pool_t* pool);
+
+// Fo analysis at a reduced sampling rate
+// The input is decimated by an integer factor to fs_analysis or higher (fs_analysis > 6 * fo_ceil, e.g. 8 kHz),
+// then analyzed with a smaller FFT size, window and filter bank. analyze_fo() returns fo in Hz as well.
+fo_context_t* create_fo_context_decimated(vocoder_context_t* vocoder, double fs_analysis);
+
+// Fo analysis with the streaming DIO
+// The DIO filter bank runs on the input stream at a reduced rate instead of filtering each frame,
+// so push_fo_stream() must be called with every input sample (before next_audio_frame()).
+// analyze_fo() then takes the candidates from the running statistics and refines them on the frame.
+fo_context_t* create_fo_context_streaming(vocoder_context_t* vocoder);
+void push_fo_stream(fo_context_t* context, real_t input);
+
+// DIO candidate of the channel in the last analyze_fo() (false: not found)
+bool get_fo_candidate(const fo_context_t* context, size_t channel, double* fo, double* rsd);
+
+// Number of the intervals in the window of the streaming DIO channel (0: DIO on each frame)
+size_t get_fo_stream_intervals(const fo_context_t* context, size_t channel);
 
 REIM_END_EXTERN_C
 #endif
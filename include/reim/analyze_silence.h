@@ -10,7 +10,7 @@ REIM_BEGIN_EXTERN_C
 
 // Analyze silence of the frame
 // Return true when the frame is silence
-bool analyze_silence(vocoder_context_t* vocoder, const double* input, double threshold);
+bool analyze_silence(vocoder_context_t* vocoder, const real_t* input, double threshold);
 
 REIM_END_EXTERN_C
 #endif
@@ -6,22 +6,54 @@ REIM_BEGIN_EXTERN_C
 #include <stdbool.h>
 #include <stddef.h>
 
+#define REIM_SP_TABLE_RESOLUTION 24.0 // entries per octave (a quarter tone)
+
+// Analysis window on the non-zero samples of the frame
+typedef struct {
+    size_t offset;  // first non-zero sample in the frame
+    size_t length;  // number of the non-zero samples
+    real_t* window; // window (length)
+    double sum;     // sum of the window (for the DC removal)
+} sp_window_t;
+
 typedef struct {
-    double* window;
-    double* x_real;
-    double* x_imag;
-    double* pspec;
-    double* spec_cumsum;
+    real_t* window;      // analysis window of the voiced frame (computed for the fo out of the table)
+    real_t* lifter;      // lifter of the voiced frame (computed for the fo out of the table)
+    complex_t* spec;     // spectrum (also used for the windowed waveform and cepstrum in-place)
+    real_t* pspec;       // power spectrum
+    double* spec_cumsum; // cumulative sum of power spectrum (double precision for the differences)
+    complex_t* scratch;  // scratch of the transforms of the vocoder
+
+    sp_window_t window_unvoiced; // analysis window of the unvoiced frames
+
+    size_t table_size;         // number of the entries of the fo (0: no table)
+    double entries_per_octave; // entries of the fo per octave
+    double table_fo_floor;     // fo of the first entry
+    sp_window_t* table_window; // analysis windows of the entries
+    real_t* table_lifter;      // lifters of the entries (table_size * numbins)
 } sp_context_t;
 
 // Create a new spectral envelope context
 sp_context_t* create_sp_context(vocoder_context_t* vocoder);
 
+// Spectral envelope with the table of the windows and the lifters
+// The entries are log-spaced from fo_floor to fo_ceil, and the voiced frames take the nearest one
+// instead of computing the window and the lifter for the fo (the fo out of the range is not rounded).
+// The envelope is analyzed at the fo rounded to the entry: 24 entries per octave (a quarter tone) differ by
+// about 0.12 dB RMS (a few dB at most in the valleys), and 48 entries by 0.07 dB RMS (at most about 2 dB).
+// The table takes numbins + 3 * fs / fo samples per entry (e.g. 85 entries and 0.5 MB in double for 16 kHz and 1024 points).
+sp_context_t* create_sp_context_tabulated(vocoder_context_t* vocoder, double entries_per_octave);
+
 // Destroy the spectral envelope context
 void destroy_sp_context(sp_context_t** context);
 
 // Analyze spectral envelope
-void analyze_sp(vocoder_context_t* vocoder, sp_context_t* context, const double* input, double fo, bool isvoiced, bool issilence, double* sp);
+void analyze_sp(vocoder_context_t* vocoder, sp_context_t* context, const real_t* input, double fo, bool isvoiced, bool issilence, real_t* sp);
+
+// Analyze spectral envelope in the log domain (natural logarithm of the power spectrum)
+// The liftered cepstrum is not exponentiated, and synthesize_new_frame_log() takes the output without the logarithm.
+// The power spectrum is floored by 1e-12 before the logarithm (exp(sp_log) = sp + 1e-12 on the unvoiced frames).
+void analyze_sp_log(vocoder_context_t* vocoder, sp_context_t* context, const real_t* input, double fo, bool isvoiced, bool issilence, real_t* sp_log);
 
 REIM_END_EXTERN_C
 #endif
@@ -23,8 +23,17 @@ void destroy_audio_frame(audio_frame_t** frame);
 
 // Process new input sample
 // If a new frame is available, returns true and sets the frame_waveform
-// (frame_waveform: double[fftsize + 1])
-bool next_audio_frame(audio_frame_t* frame, double input, double* frame_waveform);
+// (frame_waveform: real_t[fftsize + 1])
+bool next_audio_frame(audio_frame_t* frame, real_t input, real_t* frame_waveform);
+
+// Process the input samples until a new frame is available
+// Returns the number of the consumed samples (<= length).
+// If a new frame starts at the last consumed sample, sets has_new_frame to true
+// and get_audio_frame() gives the frame waveform without copying.
+size_t next_audio_frame_block(audio_frame_t* frame, const real_t* input, size_t length, bool* has_new_frame);
+
+// Get the latest frame waveform (real_t[fftsize + 1], valid until the next input)
+const real_t* get_audio_frame(const audio_frame_t* frame);
 
 REIM_END_EXTERN_C
 #endif
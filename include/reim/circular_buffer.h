@@ -5,10 +5,13 @@
 REIM_BEGIN_EXTERN_C
 
 // Circular buffer is 
+// The ring is a power of two (indexed with the mask) not less than the capacity,
+// and mirrored (2 * (mask + 1)) so that the latest values are always contiguous.
 typedef struct {
     size_t head;
     size_t capacity;
-    double* buffer;
+    size_t mask;
+    real_t* buffer;
 } circular_buffer_t;
 
 // Create a new circular buffer
@@ -18,10 +21,16 @@ circular_buffer_t* create_circular_buffer(size_t capacity);
 void destroy_circular_buffer(circular_buffer_t** cb);
 
 // Push the value to the circular buffer
-void push_circular_buffer(circular_buffer_t* cb, double value);
+void push_circular_buffer(circular_buffer_t* cb, real_t value);
+
+// Push the values to the circular buffer
+void push_block_circular_buffer(circular_buffer_t* cb, const real_t* values, size_t length);
+
+// Get the all buffer content from the oldest to the latest (capacity values, valid until the next push)
+const real_t* get_all_circular_buffer(const circular_buffer_t* cb);
 
 // Copy the all buffer content to the destination buffer
-void copy_all_circular_buffer(circular_buffer_t* cb, double* destination);
+void copy_all_circular_buffer(circular_buffer_t* cb, real_t* destination);
 
 REIM_END_EXTERN_C
 #endif
@@ -5,14 +5,16 @@
 #include <stddef.h>
 REIM_BEGIN_EXTERN_C
 
+// The capacity is a power of two (indexed with the mask).
 typedef struct {
     size_t head;
     size_t remaining;
     size_t capacity;
-    double* buffer;
+    size_t mask;
+    real_t* buffer;
 } circular_queue_t;
 
-// Create a new queue
+// Create a new queue (the capacity is rounded up to a power of two)
 circular_queue_t* create_circular_queue(size_t capacity);
 
 // Destroy the queue
@@ -22,10 +24,16 @@ void destroy_circular_queue(circular_queue_t** queue);
 size_t get_remaining_circular_queue(const circular_queue_t* queue);
 
 // Push the value to the queue
-void push_additive_circular_queue(circular_queue_t* queue, const double* buffer, size_t size);
+void push_additive_circular_queue(circular_queue_t* queue, const real_t* buffer, size_t size);
+
+// Push the value to the queue from the offset (the values before the offset are not changed)
+void push_additive_offset_circular_queue(circular_queue_t* queue, size_t offset, const real_t* buffer, size_t size);
 
 // Pop the value from the queue
-double pop_circular_queue(circular_queue_t* queue);
+real_t pop_circular_queue(circular_queue_t* queue);
+
+// Pop the values from the queue (zeros after the remaining values)
+void pop_block_circular_queue(circular_queue_t* queue, real_t* output, size_t size);
 
 REIM_END_EXTERN_C
 #endif
@@ -0,0 +1,36 @@
+#ifndef __REIM_CPU_H__
+#define __REIM_CPU_H__
+#include "reim/defines.h"
+REIM_BEGIN_EXTERN_C
+#include <stdbool.h>
+
+// Instruction sets of the SIMD kernels (the built-in FFT and the vector math)
+typedef enum {
+    CPU_ISA_SCALAR, // portable C
+    CPU_ISA_SSE2,
+    CPU_ISA_AVX2,   // AVX2 and FMA
+    CPU_ISA_AVX512, // AVX-512F
+    CPU_ISA_NEON,   // AArch64
+    CPU_ISA_COUNT,
+} cpu_isa_t;
+
+// Whether the CPU and the OS support the instruction set (detected once at the first call, thread safe)
+bool is_cpu_isa_supported(cpu_isa_t isa);
+
+// Name of the instruction set ("scalar", "sse2", "avx2", "avx512" or "neon")
+const char* get_cpu_isa_name(cpu_isa_t isa);
+
+// Instruction set of the kernels
+// The widest supported one by default, or the one named by the environment variable REIM_ISA (e.g. REIM_ISA=sse2).
+cpu_isa_t get_kernel_isa();
+
+// Override the instruction set of the kernels for the comparisons and the benchmarks
+// Returns false (and keeps the current one) if the instruction set is not supported.
+// It is safe to call while the worker pools are running; the calls already running keep the kernels they looked up.
+bool set_kernel_isa(cpu_isa_t isa);
+
+// Back to the default of get_kernel_isa()
+void reset_kernel_isa();
+
+REIM_END_EXTERN_C
+#endif
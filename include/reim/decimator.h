@@ -0,0 +1,27 @@
+#ifndef __REIM_DECIMATOR_H__
+#define __REIM_DECIMATOR_H__
+#include "reim/defines.h"
+#include <stddef.h>
+REIM_BEGIN_EXTERN_C
+
+// Decimator with an anti-aliasing FIR filter (Blackman windowed sinc, cutoff at the decimated Nyquist frequency)
+// Only the retained samples are computed (the same cost as the polyphase form).
+typedef struct {
+    size_t factor;  // decimation factor
+    size_t half;    // half length of the filter (group delay)
+    size_t length;  // filter length (2 * half + 1)
+    real_t* filter; // coefficients (length)
+} decimator_t;
+
+// Create a new decimator
+decimator_t* create_decimator(size_t factor);
+
+// Destroy the decimator
+void destroy_decimator(decimator_t** decimator);
+
+// Filter and decimate the input: output[m] is the filtered input at (offset + m * factor)
+// The samples outside of the input are regarded as zeros.
+void execute_decimator(const decimator_t* decimator, const real_t* input, size_t length, size_t offset, real_t* output, size_t count);
+
+REIM_END_EXTERN_C
+#endif
@@ -10,4 +10,12 @@
 #define REIM_END_EXTERN_C
 #endif
 
+// Sample type of the signals, spectra and their buffers
+// Define REIM_USE_FLOAT for the single precision build
+#ifdef REIM_USE_FLOAT
+typedef float real_t;
+#else
+typedef double real_t;
+#endif
+
 #endif
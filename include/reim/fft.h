@@ -1,18 +1,109 @@
 #ifndef __REIM_FFT_H__
 #define __REIM_FFT_H__
 #include "reim/defines.h"
+#include <stdbool.h>
 #include <stddef.h>
 REIM_BEGIN_EXTERN_C
 
 typedef void fft_t;
 typedef void ifft_t;
+typedef void rfft_t;
+typedef void irfft_t;
+typedef void irfft_batch_t;
+typedef void dct_t;
+typedef void dst_t;
+
+// Interleaved complex value (same layout as fftw_complex/fftwf_complex and MKL complex data)
+typedef struct {
+    real_t re;
+    real_t im;
+} complex_t;
 
 fft_t* create_fft(size_t fftsize);
 ifft_t* create_ifft(size_t fftsize);
 void destroy_fft(fft_t** fft);
 void destroy_ifft(ifft_t** ifft);
-void execute_fft(fft_t* fft, double* real, double* imag);
-void execute_ifft(ifft_t* ifft, double* real, double* imag);
+void execute_fft(fft_t* fft, real_t* real, real_t* imag);
+void execute_ifft(ifft_t* ifft, real_t* real, real_t* imag);
+
+// Real-input transforms
+// The spectrum has only the bins from DC to Nyquist frequency (fftsize / 2 + 1)
+rfft_t* create_rfft(size_t fftsize);
+irfft_t* create_irfft(size_t fftsize);
+void destroy_rfft(rfft_t** rfft);
+void destroy_irfft(irfft_t** irfft);
+void execute_rfft(rfft_t* rfft, const real_t* input, real_t* real, real_t* imag);
+void execute_irfft(irfft_t* irfft, const real_t* real, const real_t* imag, real_t* output);
+
+// In-place transforms on interleaved complex buffers (no copy)
+// The inverse transforms are NOT normalized: the results are scaled by fftsize.
+// data: complex_t[fftsize]
+void execute_fft_inplace(fft_t* fft, complex_t* data);
+void execute_ifft_inplace(ifft_t* ifft, complex_t* data);
+// data: complex_t[fftsize / 2 + 1]; the waveform is stored as real_t[fftsize] at the beginning
+void execute_rfft_inplace(rfft_t* rfft, complex_t* data);
+void execute_irfft_inplace(irfft_t* irfft, complex_t* data);
+
+// Batched in-place inverse real transforms with the same size
+// data: complex_t[count][fftsize / 2 + 1]; each waveform is stored at the beginning of its row (unnormalized)
+irfft_batch_t* create_irfft_batch(size_t fftsize, size_t count);
+void destroy_irfft_batch(irfft_batch_t** batch);
+void execute_irfft_batch(irfft_batch_t* batch, complex_t* data);
+
+// Real symmetric transforms on fftsize / 2 + 1 points (the DFT of fftsize for the even or odd sequences)
+// DCT-I: X[k] = x[0] + (-1)^k x[n] + 2 sum_{j=1}^{n-1} x[j] cos(pi j k / n), where n = fftsize / 2
+// DST-I: X[k] = 2 sum_{j=1}^{n-1} x[j] sin(pi j k / n) (x[0] and x[n] are ignored, X[0] and X[n] are zeros)
+// The DFT of the even sequence is the DCT-I, and that of the odd sequence is -i times the DST-I.
+// Both are their own inverses except for the scale of fftsize (not normalized).
+// The create_*() functions return NULL if fftsize is less than 4 (fftsg: 16) or not supported.
+// data: real_t[fftsize / 2 + 1]
+dct_t* create_dct(size_t fftsize);
+dst_t* create_dst(size_t fftsize);
+void destroy_dct(dct_t** dct);
+void destroy_dst(dst_t** dst);
+void execute_dct_inplace(dct_t* dct, real_t* data);
+void execute_dst_inplace(dst_t* dst, real_t* data);
+
+// Reentrant execution with the scratch of the caller
+// The plans are immutable and shared, but each object has its own scratch (the work area of the library and
+// the buffer of the split format interface), so an object must not run in two threads at once with the functions above.
+// The *_with_scratch() functions below only read the object: any threads can execute the same object at once,
+// each with its own scratch (e.g. one per thread, allocated before the processing).
+// scratch: allocate_fft_scratch(length) of at least get_fft_scratch_length(object) (aligned for the library)
+size_t get_fft_scratch_length(const void* object);
+complex_t* allocate_fft_scratch(size_t length);
+void free_fft_scratch(complex_t* scratch);
+void execute_fft_with_scratch(const fft_t* fft, real_t* real, real_t* imag, complex_t* scratch);
+void execute_ifft_with_scratch(const ifft_t* ifft, real_t* real, real_t* imag, complex_t* scratch);
+void execute_rfft_with_scratch(const rfft_t* rfft, const real_t* input, real_t* real, real_t* imag, complex_t* scratch);
+void execute_irfft_with_scratch(const irfft_t* irfft, const real_t* real, const real_t* imag, real_t* output, complex_t* scratch);
+void execute_fft_inplace_with_scratch(const fft_t* fft, complex_t* data, complex_t* scratch);
+void execute_ifft_inplace_with_scratch(const ifft_t* ifft, complex_t* data, complex_t* scratch);
+void execute_rfft_inplace_with_scratch(const rfft_t* rfft, complex_t* data, complex_t* scratch);
+void execute_irfft_inplace_with_scratch(const irfft_t* irfft, complex_t* data, complex_t* scratch);
+void execute_irfft_batch_with_scratch(const irfft_batch_t* batch, complex_t* data, complex_t* scratch);
+void execute_dct_inplace_with_scratch(const dct_t* dct, real_t* data, complex_t* scratch);
+void execute_dst_inplace_with_scratch(const dst_t* dst, real_t* data, complex_t* scratch);
+
+// Supported sizes
+// The native FFT supports 2^a 3^b 5^c, fftsg supports the powers of two, MKL and FFTW support any sizes.
+// is_supported_fftsize() returns true if all the transforms (complex and real) are available for the even fftsize,
+// get_next_fftsize() returns the smallest supported fftsize not less than length.
+// The create_*() functions return NULL for the unsupported sizes.
+bool is_supported_fftsize(size_t fftsize);
+size_t get_next_fftsize(size_t length);
+
+// Plan cache
+// The objects of the same type share a plan, which is created at most once per process.
+// warmup_fft() creates the plans of all types for fftsize in advance (e.g. before starting a stream),
+// clear_fft_cache() frees the plans that no object uses.
+void warmup_fft(size_t fftsize);
+void clear_fft_cache();
+
+// FFTW wisdom (returns false on failure or with the other libraries)
+bool import_fft_wisdom(const char* filename);
+bool export_fft_wisdom(const char* filename);
+
 const char* get_fft_library_name();
 
 REIM_END_EXTERN_C
@@ -0,0 +1,58 @@
+#ifndef __REIM_FRAME_ANALYZER_H__
+#define __REIM_FRAME_ANALYZER_H__
+#include "reim/defines.h"
+REIM_BEGIN_EXTERN_C
+#include "reim/analyze_ap.h"
+#include "reim/analyze_fo.h"
+#include "reim/analyze_sp.h"
+#include "reim/vocoder.h"
+#include "reim/worker_pool.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Analysis of a frame with the independent parts on a worker pool
+// The DIO channels of the fo analysis run in parallel, then the aperiodicity and the spectral envelope:
+// the envelope depends on the voicing decision of analyze_ap(), so both the voiced and the unvoiced ones are
+// computed beside it and the matching one is kept. The results are the same as the serial analysis.
+typedef struct {
+    vocoder_context_t* vocoder; // vocoder of the contexts (not owned)
+    fo_context_t* fo_context;   // fo analysis (not owned)
+    ap_context_t* ap_context;   // aperiodicity analysis (not owned)
+    sp_context_t* sp_context;   // spectral envelope analysis, also the voiced one in parallel (not owned)
+    sp_context_t* sp_unvoiced;  // spectral envelope analysis of the unvoiced one in parallel
+    real_t* sp_buffer;          // unvoiced spectral envelope in parallel (numbins)
+    worker_pool_t* pool;        // workers of the parallel parts
+    double silence_threshold;   // threshold of analyze_silence() (REIM_SILENCE_THRESHOLD by default)
+
+    // current frame (for the tasks of the pool)
+    const real_t* input;
+    bool logarithmic;
+    real_t* ap;
+    real_t* sp;
+
+    // results of the current frame
+    bool issilence;
+    double fo;
+    bool isvoiced;
+} frame_analyzer_t;
+
+// Create an analyzer on the contexts of the caller with num_workers threads besides the caller (e.g. 2)
+// The contexts must outlive the analyzer and must not be used elsewhere while analyze_frame() runs.
+// Returns NULL if the threads cannot be created.
+frame_analyzer_t* create_frame_analyzer(vocoder_context_t* vocoder, fo_context_t* fo_context, ap_context_t* ap_context,
+    sp_context_t* sp_context, size_t num_workers);
+void destroy_frame_analyzer(frame_analyzer_t** analyzer);
+
+// The same as the serial analysis of the frame:
+//     issilence = analyze_silence(vocoder, input, silence_threshold);
+//     fo = analyze_fo(vocoder, fo_context, input, input_delayed);
+//     isvoiced = analyze_ap(vocoder, ap_context, input, fo, issilence, ap);
+//     analyze_sp(vocoder, sp_context, input, fo, isvoiced, issilence, sp);
+// issilence, fo and isvoiced are stored in the analyzer. No memory is allocated.
+void analyze_frame(frame_analyzer_t* analyzer, const real_t* input, const real_t* input_delayed, real_t* ap, real_t* sp);
+
+// The same with analyze_sp_log()
+void analyze_frame_log(frame_analyzer_t* analyzer, const real_t* input, const real_t* input_delayed, real_t* ap, real_t* sp_log);
+
+REIM_END_EXTERN_C
+#endif
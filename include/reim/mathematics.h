@@ -25,8 +25,11 @@ void setup_random(random_state_t state);
 // Generate a random number in [0, 1] from uniform distribution
 double generate_uniform_random(random_state_t state);
 
+// Get the smallest power of two not less than x
+size_t get_next_pow2(size_t x);
+
 // Do ifftshift processing
-void ifftshift(const double* source, double* destination, size_t numbins);
+void ifftshift(const real_t* source, real_t* destination, size_t numbins);
 
 REIM_END_EXTERN_C
 #endif
@@ -9,28 +9,28 @@ REIM_BEGIN_EXTERN_C
 #define REIM_FREE(p) free(p)
 
 // Allocate memories for a vector (one-dimensional) buffer
-static inline double* allocate_vector(size_t length)
+static inline real_t* allocate_vector(size_t length)
 {
-    return REIM_ALLOC(length, double);
+    return REIM_ALLOC(length, real_t);
 }
 
 // Allocate memories for a matrix (two-dimensional) buffer
-static inline double** allocate_matrix(size_t row, size_t column)
+static inline real_t** allocate_matrix(size_t row, size_t column)
 {
-    double** mat = REIM_ALLOC(row, double*);
+    real_t** mat = REIM_ALLOC(row, real_t*);
     for (size_t i = 0; i < row; i++)
-        mat[i] = REIM_ALLOC(column, double);
+        mat[i] = REIM_ALLOC(column, real_t);
     return mat;
 }
 
 // Free the memories
-static inline void free_vector(double* memory)
+static inline void free_vector(real_t* memory)
 {
     REIM_FREE(memory);
 }
 
 // Free the matrix memories
-static inline void free_matrix(double** memory, size_t row)
+static inline void free_matrix(real_t** memory, size_t row)
 {
     for (size_t i = 0; i < row; i++)
         REIM_FREE(memory[i]);
@@ -9,21 +9,43 @@ REIM_BEGIN_EXTERN_C
 #include <stddef.h>
 #include <stdint.h>
 
+#define REIM_IMPULSE_TOLERANCE 1e-4 // -40 dB, suggested tolerance of the truncation
+
+// Samples of the impulse response to write (truncated by the energy)
+typedef struct {
+    size_t offset;          // first sample in the buffer of the FFT size
+    size_t length;          // number of samples
+    size_t response_offset; // first sample of the truncated response (zeros outside of it before removing DC)
+    size_t response_length; // number of samples of the truncated response
+    real_t* window;         // window to remove DC within the samples
+} impulse_support_t;
+
 typedef struct {
     bool has_pulse;
     bool has_noise;
 
-    double* spec_pulse_r; // real spectrum of periodic component
-    double* spec_pulse_i; // imag spectrum of periodic component
-    double* spec_noise_r; // real spectrum of aperiodic component
-    double* spec_noise_i; // imag spectrum of aperiodic component
+    complex_t* spec_pulse; // spectrum of periodic component
+    complex_t* spec_noise; // spectrum of aperiodic component
+
+    complex_t* spec_correction; // aperiodicity correction of the minimum phase filters (on the coarse bins)
+    dct_t* dct_ap;              // DCT-I of the coarse bins
+    dst_t* dst_ap;              // DST-I of the coarse bins
+    complex_t* scratch;         // scratch of the transforms (of the vocoder and the coarse bins)
+
+    real_t* window; // window to remove DC
+
+    real_t* impulse_pulse; // impulse response of periodic component
+    real_t* impulse_noise; // impulse response of aperiodic component
+    complex_t* temp;       // temporary buffer for impulse generation (spectrum, then waveform in-place) and the cepstrum
 
-    double* window; // window to remove DC
+    real_t* impulse_base;  // impulse response of periodic component without the fractional delay
+    bool has_impulse_base; // impulse_base is rendered in the current frame
+    real_t* delay_bank;    // polyphase bank of the fractional delay filters
+    real_t* delay_filter;  // fractional delay filter interpolated from the bank
 
-    double* impulse_pulse; // impulse response of periodic component
-    double* impulse_noise; // impulse response of aperiodic component
-    double* temp_r;        // real temporary buffer for impulse generation
-    double* temp_i;        // imag temporary buffer for impulse generation
+    double tolerance;                // energy tolerance of the truncation of the impulse responses (0: no truncation, default)
+    impulse_support_t support_pulse; // samples of the periodic impulse response in the current frame
+    impulse_support_t support_noise; // samples of the aperiodic impulse response in the current frame
 
     double interval;   // time interval of periodic excitation
     int32_t pulse_int; // samples left until next excitation (integer part)
@@ -34,14 +56,37 @@ typedef struct {
     size_t interval_random; // random offset of aperiodic excitation
     double gain_noise;      // gain of aperiodic excitation
     size_t noise_int;       // samples left until next interval
+    bool has_impulse_noise; // impulse_noise is rendered in the current frame
+
+    bool noise_block;       // render the aperiodic component of each frame at once
+    size_t noise_length;    // samples rendered at once (the shortest frame period)
+    size_t noise_rendered;  // samples left whose aperiodic component is already rendered
+    size_t noise_pending;   // samples left in the frame which are not rendered yet
+    complex_t* spec_window; // spectrum of the window to remove DC (block mode)
+    real_t* impulse_velvet; // aperiodic component of the frame (block mode, fftsize + fftsize / 4)
 
     circular_queue_t* buffer;
 } synthesis_context_t;
 
 synthesis_context_t* create_synthesis_context(const vocoder_context_t* vocoder);
+
+// Synthesis with the block rendering of the aperiodic component
+// synthesize_new_frame() generates the velvet noise sequence of the frame and convolves it with the filter by the FFT,
+// instead of adding the impulse response at every excitation. The samples of a frame longer than the shortest frame period
+// go through the excitations, and those already rendered are played across silent frames,
+// so the random sequence is the same as create_synthesis_context().
+synthesis_context_t* create_synthesis_context_block_noise(const vocoder_context_t* vocoder);
+
 void destroy_synthesis_context(synthesis_context_t** context);
-void synthesize_new_frame(vocoder_context_t* vocoder, synthesis_context_t* context, double fo, bool isvoiced, bool issilence, double* ap, double* sp);
-double synthesize_next_sample(vocoder_context_t* vocoder, synthesis_context_t* context);
+void synthesize_new_frame(vocoder_context_t* vocoder, synthesis_context_t* context, double fo, bool isvoiced, bool issilence, const real_t* ap, const real_t* sp);
+
+// Synthesize with the spectral envelope in the log domain (natural logarithm of the power spectrum, see analyze_sp_log())
+void synthesize_new_frame_log(vocoder_context_t* vocoder, synthesis_context_t* context, double fo, bool isvoiced, bool issilence, const real_t* ap, const real_t* sp_log);
+
+real_t synthesize_next_sample(vocoder_context_t* vocoder, synthesis_context_t* context);
+
+// Synthesize the next samples (equivalent to calling synthesize_next_sample() for each sample)
+void synthesize_block(vocoder_context_t* vocoder, synthesis_context_t* context, real_t* output, size_t length);
 
 REIM_END_EXTERN_C
 #endif
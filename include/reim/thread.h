@@ -0,0 +1,191 @@
+#ifndef __REIM_THREAD_H__
+#define __REIM_THREAD_H__
+#include "reim/defines.h"
+REIM_BEGIN_EXTERN_C
+#include <stdbool.h>
+
+#ifdef _WIN32
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+typedef SRWLOCK mutex_t;
+#define MUTEX_INITIALIZER SRWLOCK_INIT
+
+static inline void lock_mutex(mutex_t* mutex)
+{
+    AcquireSRWLockExclusive(mutex);
+}
+
+static inline void unlock_mutex(mutex_t* mutex)
+{
+    ReleaseSRWLockExclusive(mutex);
+}
+
+static inline void init_mutex(mutex_t* mutex)
+{
+    InitializeSRWLock(mutex);
+}
+
+static inline void destroy_mutex(mutex_t* mutex)
+{
+    (void)mutex;
+}
+
+typedef CONDITION_VARIABLE condition_t;
+
+static inline void init_condition(condition_t* condition)
+{
+    InitializeConditionVariable(condition);
+}
+
+static inline void destroy_condition(condition_t* condition)
+{
+    (void)condition;
+}
+
+// Unlock the mutex, wait for the notification, then lock the mutex again
+static inline void wait_condition(condition_t* condition, mutex_t* mutex)
+{
+    SleepConditionVariableSRW(condition, mutex, INFINITE, 0);
+}
+
+static inline void notify_all_condition(condition_t* condition)
+{
+    WakeAllConditionVariable(condition);
+}
+
+typedef struct {
+    HANDLE handle;
+    void (*function)(void*);
+    void* argument;
+} thread_t;
+
+static inline DWORD WINAPI run_thread_function(LPVOID thread)
+{
+    ((thread_t*)thread)->function(((thread_t*)thread)->argument);
+    return 0;
+}
+
+// The thread must stay at the same address until join_thread()
+static inline bool create_thread(thread_t* thread, void (*function)(void*), void* argument)
+{
+    thread->function = function;
+    thread->argument = argument;
+    thread->handle = CreateThread(NULL, 0, run_thread_function, thread, 0, NULL);
+    return thread->handle != NULL;
+}
+
+static inline void join_thread(thread_t* thread)
+{
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+}
+
+// Integer read and written by the threads without a lock (release on the store, acquire on the load)
+typedef volatile LONG atomic_int_t;
+
+static inline int load_atomic_int(atomic_int_t* value)
+{
+    return (int)InterlockedCompareExchange(value, 0, 0);
+}
+
+static inline void store_atomic_int(atomic_int_t* value, int desired)
+{
+    InterlockedExchange(value, (LONG)desired);
+}
+
+#else
+
+#include <pthread.h>
+
+typedef pthread_mutex_t mutex_t;
+#define MUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
+
+static inline void lock_mutex(mutex_t* mutex)
+{
+    pthread_mutex_lock(mutex);
+}
+
+static inline void unlock_mutex(mutex_t* mutex)
+{
+    pthread_mutex_unlock(mutex);
+}
+
+static inline void init_mutex(mutex_t* mutex)
+{
+    pthread_mutex_init(mutex, NULL);
+}
+
+static inline void destroy_mutex(mutex_t* mutex)
+{
+    pthread_mutex_destroy(mutex);
+}
+
+typedef pthread_cond_t condition_t;
+
+static inline void init_condition(condition_t* condition)
+{
+    pthread_cond_init(condition, NULL);
+}
+
+static inline void destroy_condition(condition_t* condition)
+{
+    pthread_cond_destroy(condition);
+}
+
+// Unlock the mutex, wait for the notification, then lock the mutex again
+static inline void wait_condition(condition_t* condition, mutex_t* mutex)
+{
+    pthread_cond_wait(condition, mutex);
+}
+
+static inline void notify_all_condition(condition_t* condition)
+{
+    pthread_cond_broadcast(condition);
+}
+
+typedef struct {
+    pthread_t handle;
+    void (*function)(void*);
+    void* argument;
+} thread_t;
+
+static inline void* run_thread_function(void* thread)
+{
+    ((thread_t*)thread)->function(((thread_t*)thread)->argument);
+    return NULL;
+}
+
+// The thread must stay at the same address until join_thread()
+static inline bool create_thread(thread_t* thread, void (*function)(void*), void* argument)
+{
+    thread->function = function;
+    thread->argument = argument;
+    return pthread_create(&thread->handle, NULL, run_thread_function, thread) == 0;
+}
+
+static inline void join_thread(thread_t* thread)
+{
+    pthread_join(thread->handle, NULL);
+}
+
+// Integer read and written by the threads without a lock (release on the store, acquire on the load)
+typedef int atomic_int_t;
+
+static inline int load_atomic_int(atomic_int_t* value)
+{
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+static inline void store_atomic_int(atomic_int_t* value, int desired)
+{
+    __atomic_store_n(value, desired, __ATOMIC_RELEASE);
+}
+
+#endif
+
+REIM_END_EXTERN_C
+#endif
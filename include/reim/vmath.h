@@ -0,0 +1,38 @@
+#ifndef __REIM_VMATH_H__
+#define __REIM_VMATH_H__
+#include "reim/defines.h"
+REIM_BEGIN_EXTERN_C
+#include "reim/fft.h"
+#include <stddef.h>
+
+// Vectorized math functions on arrays (SSE2, AVX2, AVX-512 or NEON, selected at runtime like the native FFT)
+// The outputs may be the same arrays as the inputs (in-place). Each element gives the same result
+// regardless of its position and the length of the array.
+//
+// Maximum relative errors (double / float build) within the ranges below:
+//   vlog:    5e-16 / 2e-7   x: positive normal numbers
+//   vexp:    5e-16 / 2e-7   x: clamped to [-708, 709] / [-87, 88]
+//   vsincos: 3e-16 / 1e-7 of the absolute error, |x| < 1e6 / 8192
+//   vatan2:  8e-16 / 4e-7   y, x: finite (atan2(0, 0) is 0)
+//   vabs2:   the same as re * re + im * im
+
+// Name of the selected instruction set
+const char* get_vmath_kernel_name();
+
+// y = log(x)
+void vlog(const real_t* x, real_t* y, size_t n);
+
+// y = exp(x)
+void vexp(const real_t* x, real_t* y, size_t n);
+
+// s = sin(x), c = cos(x)
+void vsincos(const real_t* x, real_t* s, real_t* c, size_t n);
+
+// angle = atan2(y, x)
+void vatan2(const real_t* y, const real_t* x, real_t* angle, size_t n);
+
+// y = |x|^2
+void vabs2(const complex_t* x, real_t* y, size_t n);
+
+REIM_END_EXTERN_C
+#endif
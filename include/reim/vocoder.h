@@ -12,12 +12,20 @@ typedef struct {
     double fo_ceil;  // upper bounds of fo
     size_t fftsize;  // FFT size
     size_t numbins;  // number of bins from DC to Nyquist frequency
-    fft_t* fft;      // FFT
-    ifft_t* ifft;    // IFFT
+    rfft_t* rfft;    // real FFT
+    irfft_t* irfft;  // real IFFT
+    dct_t* dct;      // DCT-I (cepstrum of the log spectrum)
+    dst_t* dst;      // DST-I (phase of the minimum phase filters)
 } vocoder_context_t;
 
+// fftsize must be supported by the FFT (is_supported_fftsize()),
+// e.g. get_next_fftsize((size_t)ceil(4 * fs / fo_floor)) fits the frame to the longest analysis window.
 vocoder_context_t* create_vocoder_context(double period, size_t fftsize, double fo_floor, double fo_ceil, double fs);
 void destroy_vocoder_context(vocoder_context_t** vocoder);
 
+// Length of the scratch for the *_with_scratch() transforms of all the FFT objects above
+// The analysis and synthesis contexts have their own scratch, so the contexts of one vocoder can run in different threads at once.
+size_t get_vocoder_scratch_length(const vocoder_context_t* vocoder);
+
 REIM_END_EXTERN_C
 #endif
@@ -0,0 +1,42 @@
+#ifndef __REIM_WORKER_POOL_H__
+#define __REIM_WORKER_POOL_H__
+#include "reim/defines.h"
+REIM_BEGIN_EXTERN_C
+#include "reim/thread.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Task of the pool: called once for each index of the job
+typedef void (*worker_task_t)(void* userdata, size_t index);
+
+// Persistent worker threads for the independent parts of a frame
+// The threads are created once and sleep between the jobs, so a job only costs the wake-ups.
+typedef struct {
+    size_t num_workers; // number of the worker threads (the caller of run_worker_pool() is one more)
+    thread_t* workers;  // worker threads (num_workers)
+    mutex_t mutex;      // guards all the fields below
+    condition_t wakeup; // a new job or the stop
+    condition_t done;   // all the tasks of the job are finished
+
+    worker_task_t task; // task of the current job
+    void* userdata;     // argument of the task
+    size_t count;       // number of the tasks in the current job
+    size_t next;        // next index to take
+    size_t finished;    // number of the finished tasks
+    size_t generation;  // number of the jobs so far (the workers wait for a new one)
+    bool stop;          // the workers exit
+} worker_pool_t;
+
+// Create a pool with num_workers threads (0: no threads, the jobs run on the caller)
+// Returns NULL if the threads cannot be created.
+worker_pool_t* create_worker_pool(size_t num_workers);
+void destroy_worker_pool(worker_pool_t** pool);
+
+// Run task(userdata, index) for every index in [0, count) on the workers and the calling thread,
+// and return when all of them are finished (pool: NULL runs them in order on the caller).
+// The tasks must not depend on each other or on the thread that runs them (e.g. each writes only its own outputs),
+// then the results are the same as the serial run. No memory is allocated, and a job must not start another one.
+void run_worker_pool(worker_pool_t* pool, worker_task_t task, void* userdata, size_t count);
+
+REIM_END_EXTERN_C
+#endif
@@ -12,7 +12,7 @@ static double blackman_window(double index, double fftsize, double length)
     return 0.42 + 0.5 * cos(wt) + 0.08 * cos(2 * wt);
 }
 
-static bool estimate_is_voiced(const double* input, double* re, double* im, size_t fftsize, double fo, double fs, fft_t* fft)
+static bool estimate_is_voiced(const real_t* input, complex_t* spec, size_t fftsize, double fo, double fs, const rfft_t* rfft, complex_t* scratch)
 {
     if (fs < 16000) {
         return true;
@@ -20,14 +20,11 @@ static bool estimate_is_voiced(const double* input, double* re, double* im, size
 
     // power spectrum
     const double window_length = MIN(1.5 * fs / fo, fftsize);
+    real_t* waveform = (real_t*)spec;
     for (size_t i = 0; i < fftsize; i++) {
-        re[i] = input[i] * blackman_window(i, fftsize, window_length);
-        im[i] = 0.0;
-    }
-    execute_fft(fft, re, im);
-    for (size_t k = 0; k <= fftsize / 2; k++) {
-        re[k] = COMPLEX_ABS2(re[k], im[k]);
+        waveform[i] = input[i] * blackman_window(i, fftsize, window_length);
     }
+    execute_rfft_inplace_with_scratch(rfft, spec, scratch);
 
     // D4C LoveTrain
     const size_t indexLower = (size_t)floor(100 / fs * fftsize);
@@ -36,12 +33,12 @@ static bool estimate_is_voiced(const double* input, double* re, double* im, size
 
     double weight1 = 1e-6;
     for (size_t k = indexLower + 1; k <= indexUpper1; k++) {
-        weight1 += re[k];
+        weight1 += COMPLEX_ABS2(spec[k].re, spec[k].im);
     }
 
     double weight2 = weight1;
     for (size_t k = indexUpper1 + 1; k <= indexUpper2; k++) {
-        weight2 += re[k];
+        weight2 += COMPLEX_ABS2(spec[k].re, spec[k].im);
     }
 
     return weight1 / weight2 > 0.7;
@@ -49,25 +46,25 @@ static bool estimate_is_voiced(const double* input, double* re, double* im, size
 
 ap_context_t* create_ap_context(vocoder_context_t* vocoder)
 {
-    const size_t fftsize = vocoder->fftsize;
+    const size_t numbins = vocoder->numbins;
 
     ap_context_t* context = REIM_ALLOC_SINGLE(ap_context_t);
-    context->x_real = allocate_vector(fftsize);
-    context->x_imag = allocate_vector(fftsize);
+    context->spec = REIM_ALLOC(numbins, complex_t);
+    context->scratch = allocate_fft_scratch(get_vocoder_scratch_length(vocoder));
 
     return context;
 }
 
 void destroy_ap_context(ap_context_t** context)
 {
-    free_vector((*context)->x_real);
-    free_vector((*context)->x_imag);
+    REIM_FREE((*context)->spec);
+    free_fft_scratch((*context)->scratch);
 
     REIM_FREE(*context);
     *context = NULL;
 }
 
-bool analyze_ap(vocoder_context_t* vocoder, ap_context_t* context, const double* input, double fo, bool issilence, double* ap)
+bool analyze_ap(vocoder_context_t* vocoder, ap_context_t* context, const real_t* input, double fo, bool issilence, real_t* ap)
 {
     const double fs = vocoder->fs;
     const double fo_floor = vocoder->fo_floor;
@@ -81,7 +78,7 @@ bool analyze_ap(vocoder_context_t* vocoder, ap_context_t* context, const double*
     }
 
     // estimate voiced/unvoiced
-    if (!estimate_is_voiced(input, context->x_real, context->x_imag, fftsize, fo, fs, vocoder->fft)) {
+    if (!estimate_is_voiced(input, context->spec, fftsize, fo, fs, vocoder->rfft, context->scratch)) {
         goto when_unvoiced;
     }
 
@@ -6,7 +6,68 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-static double get_interpolated_spectrum(double freq, double fs, double* spec, size_t numbins)
+// Band-limited channel of DIO
+// Only the in-band bins of the LPF are kept, and the filtered waveform is obtained at a decimated rate.
+struct fo_channel {
+    size_t fftsize;  // size of the decimated IFFT
+    size_t numbins;  // number of the bins of the decimated IFFT (fftsize / 2 + 1)
+    size_t passbins; // number of the in-band bins of the LPF (<= numbins)
+    size_t offset;   // offset caused by the LPF (decimated samples)
+    double fs;       // sampling frequency of the decimated waveform
+    real_t* filter;  // in-band part of the LPF (passbins, including the IFFT normalization)
+    complex_t* data; // filtered spectrum, then decimated waveform
+    irfft_t* ifft;   // decimated IFFT
+    bool found;      // the candidate is found in the current frame
+    double fo;       // candidate of the current frame
+    double rsd;      // relative standard deviation of the candidate
+};
+
+// Weighted statistics of the intervals between the events (zero-crossings, peaks and dips)
+typedef struct {
+    double denominator;
+    double sum_freq;
+    double sum_square_freq;
+} zerocross_stats_t;
+
+// Intervals between the events of one kind in the analysis window (FIFO)
+typedef struct {
+    double last;      // position of the last event (negative: none)
+    size_t head;      // index of the oldest interval
+    size_t count;     // number of the intervals
+    size_t capacity;  // maximum number of the intervals
+    double* start;    // start positions of the intervals (capacity)
+    double* interval; // lengths of the intervals (capacity)
+} fo_events_t;
+
+// Channel of the streaming DIO
+// The LPF runs continuously at the stream rate, and the event statistics are kept as running sums over the window.
+typedef struct {
+    size_t length;           // length of the LPF (odd)
+    real_t* filter;          // LPF (length)
+    size_t window;           // length of the analysis window (stream samples)
+    size_t position;         // number of the filtered samples so far
+    real_t filtered[2];      // last two filtered samples
+    fo_events_t events[4];   // positive zero-crossings, negative zero-crossings, peaks and dips
+    zerocross_stats_t stats; // statistics of the intervals in the events
+} fo_stream_channel_t;
+
+// Streaming DIO fed with every input sample
+struct fo_stream {
+    double fs;                     // sampling frequency of the stream
+    decimator_t* decimator;        // anti-aliasing decimator to the stream rate
+    size_t phase;                  // number of the input samples since the last stream sample
+    size_t input_head;             // oldest input sample in the history
+    real_t* input;                 // input history (mirrored, 2 * decimator->length)
+    double dc_coef;                // coefficient of the DC removal
+    double dc_input;               // previous input of the DC removal
+    double dc_output;              // previous output of the DC removal
+    size_t history_length;         // length of the stream history (the longest LPF)
+    size_t history_head;           // oldest stream sample in the history
+    real_t* history;               // stream history (mirrored, 2 * history_length)
+    fo_stream_channel_t* channels; // filter bank for DIO (num_candidates)
+};
+
+static double get_interpolated_spectrum(double freq, double fs, real_t* spec, size_t numbins)
 {
     double position = CLAMP_INDEX(freq / (fs / 2) * (numbins - 1), numbins - 1); // [0, numbins-2]
     size_t index = floor(position);
@@ -14,7 +75,31 @@ static double get_interpolated_spectrum(double freq, double fs, double* spec, si
     return (1.0 - delta) * spec[index] + delta * spec[index + 1];
 }
 
-static double refine_fo(double fo, double fo_floor, double fo_ceil, double fs, double* ifreqf, double* pspec, size_t numbins)
+static double get_instantaneous_frequency(fo_context_t* context, size_t k)
+{
+    if (!context->ifreqf_ready[k]) {
+        if (!context->specd_ready) {
+            execute_rfft_inplace(context->rfft, context->specd);
+            context->specd_ready = true;
+        }
+        const complex_t x = context->spec[k];
+        const complex_t xd = context->specd[k];
+        context->ifreqf[k] = INSTFREQ(x.re, x.im, xd.re, xd.im, context->fs);
+        context->ifreqf_ready[k] = true;
+    }
+    return context->ifreqf[k];
+}
+
+static double get_interpolated_instantaneous_frequency(fo_context_t* context, double freq)
+{
+    const size_t numbins = context->numbins;
+    double position = CLAMP_INDEX(freq / (context->fs / 2) * (numbins - 1), numbins - 1); // [0, numbins-2]
+    size_t index = floor(position);
+    double delta = position - index;
+    return (1.0 - delta) * get_instantaneous_frequency(context, index) + delta * get_instantaneous_frequency(context, index + 1);
+}
+
+static double refine_fo(fo_context_t* context, double fo, double fo_floor, double fo_ceil)
 {
     const size_t harmonics = 3;
 
@@ -22,8 +107,8 @@ static double refine_fo(double fo, double fo_floor, double fo_ceil, double fs, d
     double sum_freq = 0;
     double denominator = 0;
     for (size_t h = 1; h <= harmonics; h++) {
-        double freq = get_interpolated_spectrum(fo * h, fs, ifreqf, numbins);
-        double weight = get_interpolated_spectrum(fo * h, fs, pspec, numbins);
+        double freq = get_interpolated_instantaneous_frequency(context, fo * h);
+        double weight = get_interpolated_spectrum(fo * h, context->fs, context->pspec, context->numbins);
         sum_freq += freq * weight;
         denominator += h * weight;
     }
@@ -36,7 +121,7 @@ static double refine_fo(double fo, double fo_floor, double fo_ceil, double fs, d
     return refined_fo;
 }
 
-static double get_harmonic_score(double fo, double fs, double* pspec, size_t numbins)
+static double get_harmonic_score(double fo, double fs, real_t* pspec, size_t numbins)
 {
     const size_t harmonics = 3;
     double score = 1.0;
@@ -48,80 +133,85 @@ static double get_harmonic_score(double fo, double fs, double* pspec, size_t num
     return score;
 }
 
-static bool analyze_fo_with_zerocross(double* x, size_t length, double fs, double* result_fo, double* result_rsd)
+static void add_zerocross_interval(zerocross_stats_t* stats, double* last, double position, double fs)
 {
-    int32_t last_positive = -1;
-    int32_t last_negative = -1;
-    int32_t last_peak = -1;
-    int32_t last_dip = -1;
-
-    double denominator = 0.0;
-    double sum_freq = 0.0;
-    double sum_square_freq = 0.0;
+    if (*last >= 0.0) {
+        double interval = position - *last;
+        double freq = fs / interval;
+        stats->denominator += interval;
+        stats->sum_freq += freq * interval;
+        stats->sum_square_freq += freq * freq * interval;
+    }
+    *last = position;
+}
 
-    double xprev = x[0];
-    double xdiffprev = x[1] - x[0];
-    for (size_t i = 1; i < length - 1; i++) {
-        double xcurr = x[i];
-        double xdiffcurr = x[i + 1] - x[i];
-        if (xprev < 0 && xcurr >= 0) {
-            if (last_positive >= 0) {
-                double interval = (double)i - last_positive;
-                double freq = fs / interval;
-                denominator += interval;
-                sum_freq += freq * interval;
-                sum_square_freq += freq * freq * interval;
-            }
-            last_positive = i;
-        } else if (xprev > 0 && xcurr <= 0) {
-            if (last_negative >= 0) {
-                double interval = (double)i - last_negative;
-                double freq = fs / interval;
-                denominator += interval;
-                sum_freq += freq * interval;
-                sum_square_freq += freq * freq * interval;
-            }
-            last_negative = i;
-        }
-        if (xdiffprev < 0 && xdiffcurr >= 0) {
-            if (last_peak >= 0) {
-                double interval = (double)i - last_peak;
-                double freq = fs / interval;
-                denominator += interval;
-                sum_freq += freq * interval;
-                sum_square_freq += freq * freq * interval;
-            }
-            last_peak = i;
-        } else if (xdiffprev > 0 && xdiffcurr <= 0) {
-            if (last_dip > 1) {
-                double interval = (double)i - last_dip;
-                double freq = fs / interval;
-                denominator += interval;
-                sum_freq += freq * interval;
-                sum_square_freq += freq * freq * interval;
-            }
-            last_dip = i;
-        }
-        xprev = xcurr;
-        xdiffprev = xdiffcurr;
+// Kinds of the events
+enum {
+    ZEROCROSS_POSITIVE,
+    ZEROCROSS_NEGATIVE,
+    ZEROCROSS_PEAK,
+    ZEROCROSS_DIP,
+    ZEROCROSS_KINDS
+};
+
+// Locate the events around the sample i between the samples by linear interpolation (negative: none),
+// so the band-limited waveform can be analyzed at a decimated rate.
+static void find_zerocross_events(double xprev, double xcurr, double xnext, double i, double* positions)
+{
+    const double xdiffprev = xcurr - xprev;
+    const double xdiffcurr = xnext - xcurr;
+    for (size_t kind = 0; kind < ZEROCROSS_KINDS; kind++) {
+        positions[kind] = -1.0;
+    }
+    // crossing of the waveform between i - 1 and i, crossing of the difference between i - 0.5 and i + 0.5
+    if (xprev < 0 && xcurr >= 0) {
+        positions[ZEROCROSS_POSITIVE] = i - 1 + xprev / (xprev - xcurr);
+    } else if (xprev > 0 && xcurr <= 0) {
+        positions[ZEROCROSS_NEGATIVE] = i - 1 + xprev / (xprev - xcurr);
     }
+    if (xdiffprev < 0 && xdiffcurr >= 0) {
+        positions[ZEROCROSS_PEAK] = i - 0.5 + xdiffprev / (xdiffprev - xdiffcurr);
+    } else if (xdiffprev > 0 && xdiffcurr <= 0) {
+        positions[ZEROCROSS_DIP] = i - 0.5 + xdiffprev / (xdiffprev - xdiffcurr);
+    }
+}
 
-    if (denominator <= 0.0) {
+static bool get_zerocross_fo(const zerocross_stats_t* stats, double fs, double* result_fo, double* result_rsd)
+{
+    if (stats->denominator <= 0.0) {
         return false;
     }
 
-    double mean_freq = sum_freq / denominator;
+    double mean_freq = stats->sum_freq / stats->denominator;
     if (mean_freq <= 0.0 || mean_freq > fs / 2) {
         return false;
     }
 
-    double std_freq = sqrt(sum_square_freq / denominator - mean_freq);
+    double std_freq = sqrt(stats->sum_square_freq / stats->denominator - mean_freq);
 
     *result_fo = mean_freq;
     *result_rsd = std_freq / mean_freq; // relative standard deviation, smaller is better
     return true;
 }
 
+static bool analyze_fo_with_zerocross(const real_t* x, size_t length, double fs, double* result_fo, double* result_rsd)
+{
+    double last[ZEROCROSS_KINDS] = { -1.0, -1.0, -1.0, -1.0 };
+    zerocross_stats_t stats = { 0.0, 0.0, 0.0 };
+
+    for (size_t i = 1; i < length - 1; i++) {
+        double positions[ZEROCROSS_KINDS];
+        find_zerocross_events(x[i - 1], x[i], x[i + 1], i, positions);
+        for (size_t kind = 0; kind < ZEROCROSS_KINDS; kind++) {
+            if (positions[kind] >= 0.0) {
+                add_zerocross_interval(&stats, &last[kind], positions[kind], fs);
+            }
+        }
+    }
+
+    return get_zerocross_fo(&stats, fs, result_fo, result_rsd);
+}
+
 static double nuttall_window(double index, double fftsize, double length)
 {
     double wt = 2 * REIM_PI * (index - (fftsize - 1) / 2) / length;
@@ -130,46 +220,277 @@ static double nuttall_window(double index, double fftsize, double length)
     return 0.355768 + 0.487396 * cos(wt) + 0.144232 * cos(2 * wt) + 0.012604 * cos(3 * wt);
 }
 
-fo_context_t* create_fo_context(vocoder_context_t *vocoder)
+// Filter bank of DIO on each frame
+static fo_channel_t* create_fo_channels(fo_context_t* context, double fo_floor, double channels_per_octave)
 {
-    fo_context_t* context = REIM_ALLOC_SINGLE(fo_context_t);
-    const double fs = vocoder->fs;
-    const double fo_floor = vocoder->fo_floor;
-    const double fo_ceil = vocoder->fo_ceil;
-    const size_t fftsize = vocoder->fftsize;
-    const size_t numbins = vocoder->numbins;
-
-    // DIO settings
-    const double channels_per_octave = 2;
-    const size_t num_candidates = (size_t)ceil(log2(fo_ceil / fo_floor) * channels_per_octave);
-    context->num_candidates = num_candidates;
+    const double fs = context->fs;
+    const size_t fftsize = context->fftsize;
+    const size_t numbins = context->numbins;
+    const size_t num_candidates = context->num_candidates;
 
     // LPF for DIO
-    context->channel_filters = allocate_matrix(num_candidates, fftsize);
-    context->channel_offsets = REIM_ALLOC(num_candidates, size_t);
-    double* xr = allocate_vector(fftsize);
-    double* xi = allocate_vector(fftsize);
+    // The bins above the main lobe of the LPF are dropped (below -80 dB),
+    // and the IFFT is shortened to cover the rest with 2x oversampling for the zero-crossing detection.
+    const double stopband = 1e-4;
+    const size_t oversampling = 2;
+    fo_channel_t* channels = REIM_ALLOC(num_candidates, fo_channel_t);
+    complex_t* x = REIM_ALLOC(numbins, complex_t);
     for (size_t ch = 0; ch < num_candidates; ch++) {
+        fo_channel_t* channel = &channels[ch];
         const double frequency = fo_floor * pow(2.0, (1.0 + ch) / channels_per_octave);
 
         // window length
         const double lpf_window_length = ceil(fs / frequency);
 
         // create Nuttall window LPF
-        for (size_t k = 0; k < fftsize; k++) {
-            xr[k] = nuttall_window(k, fftsize, lpf_window_length);
-            xi[k] = 0.0;
+        real_t* waveform = (real_t*)x;
+        for (size_t i = 0; i < fftsize; i++) {
+            waveform[i] = nuttall_window(i, fftsize, lpf_window_length);
         }
-        execute_fft(vocoder->fft, xr, xi);
-        for (size_t k = 0; k < fftsize; k++) {
-            context->channel_filters[ch][k] = COMPLEX_ABS(xr[k], xi[k]);
+        execute_rfft_inplace(context->rfft, x);
+
+        // in-band bins
+        const double gain = COMPLEX_ABS(x[0].re, x[0].im);
+        size_t passbins = numbins;
+        while (passbins > 1 && COMPLEX_ABS(x[passbins - 1].re, x[passbins - 1].im) < stopband * gain) {
+            passbins--;
+        }
+
+        // decimated IFFT (not longer than the original one)
+        size_t decimated_fftsize = get_next_fftsize(oversampling * 2 * (passbins - 1));
+        if (decimated_fftsize >= fftsize) {
+            decimated_fftsize = fftsize;
+        }
+        channel->fftsize = decimated_fftsize;
+        channel->numbins = decimated_fftsize / 2 + 1;
+        channel->passbins = MIN(passbins, channel->numbins);
+        channel->fs = fs * decimated_fftsize / fftsize;
+        channel->ifft = create_irfft(decimated_fftsize);
+        channel->data = REIM_ALLOC(channel->numbins, complex_t);
+
+        // the normalization of the unscaled IFFT is folded into the filter
+        // (the original fftsize, as the decimated waveform is sampled from the full-rate one)
+        channel->filter = allocate_vector(channel->passbins);
+        for (size_t k = 0; k < channel->passbins; k++) {
+            channel->filter[k] = COMPLEX_ABS(x[k].re, x[k].im) / fftsize;
         }
 
         // offset caused by the LPF
-        context->channel_offsets[ch] = (size_t)lpf_window_length;
+        channel->offset = (size_t)ceil(lpf_window_length * decimated_fftsize / fftsize);
+
+        channel->found = false;
+        channel->fo = 0.0;
+        channel->rsd = 0.0;
+    }
+    REIM_FREE(x);
+
+    return channels;
+}
+
+// Filter bank of the streaming DIO
+// The input is decimated to 8 times fo_ceil or higher, then each channel runs the Nuttall LPF in the time domain.
+static fo_stream_t* create_fo_stream(vocoder_context_t* vocoder, fo_context_t* context, double channels_per_octave)
+{
+    fo_stream_t* stream = REIM_ALLOC_SINGLE(fo_stream_t);
+    const size_t factor = (size_t)MAX(floor(vocoder->fs / (8 * vocoder->fo_ceil)), 1);
+    const double fs = vocoder->fs / factor;
+    stream->fs = fs;
+
+    // input history for the decimator
+    stream->decimator = create_decimator(factor);
+    stream->phase = 0;
+    stream->input_head = 0;
+    stream->input = allocate_vector(2 * stream->decimator->length);
+    for (size_t i = 0; i < 2 * stream->decimator->length; i++) {
+        stream->input[i] = 0.0;
+    }
+
+    // DC removal (one-pole highpass at a quarter of fo_floor) instead of the mean removal of each frame
+    stream->dc_coef = exp(-2 * REIM_PI * vocoder->fo_floor / 4 / fs);
+    stream->dc_input = 0.0;
+    stream->dc_output = 0.0;
+
+    // LPF and the analysis window of each channel
+    stream->history_length = 1;
+    stream->channels = REIM_ALLOC(context->num_candidates, fo_stream_channel_t);
+    for (size_t ch = 0; ch < context->num_candidates; ch++) {
+        fo_stream_channel_t* channel = &stream->channels[ch];
+        const double frequency = vocoder->fo_floor * pow(2.0, (1.0 + ch) / channels_per_octave);
+        const double lpf_window_length = fs / frequency;
+
+        channel->length = 2 * (size_t)floor(lpf_window_length / 2) + 1;
+        channel->filter = allocate_vector(channel->length);
+        double sum = 0.0;
+        for (size_t i = 0; i < channel->length; i++) {
+            channel->filter[i] = nuttall_window(i, channel->length, lpf_window_length);
+            sum += channel->filter[i];
+        }
+        for (size_t i = 0; i < channel->length; i++) {
+            channel->filter[i] /= sum;
+        }
+        stream->history_length = MAX(stream->history_length, channel->length);
+
+        // the same span as the frame analysis (the frame without the offset caused by the LPF)
+        channel->window = (size_t)floor((vocoder->fftsize - ceil(vocoder->fs / frequency)) / factor);
+        channel->position = 0;
+        channel->filtered[0] = 0.0;
+        channel->filtered[1] = 0.0;
+        for (size_t kind = 0; kind < ZEROCROSS_KINDS; kind++) {
+            fo_events_t* events = &channel->events[kind];
+            events->last = -1.0;
+            events->head = 0;
+            events->count = 0;
+            events->capacity = channel->window + 2;
+            events->start = REIM_ALLOC(events->capacity, double);
+            events->interval = REIM_ALLOC(events->capacity, double);
+        }
+        channel->stats.denominator = 0.0;
+        channel->stats.sum_freq = 0.0;
+        channel->stats.sum_square_freq = 0.0;
+    }
+
+    // history of the stream for the LPFs
+    stream->history_head = 0;
+    stream->history = allocate_vector(2 * stream->history_length);
+    for (size_t i = 0; i < 2 * stream->history_length; i++) {
+        stream->history[i] = 0.0;
+    }
+
+    return stream;
+}
+
+static void destroy_fo_stream(fo_stream_t** stream, size_t num_candidates)
+{
+    for (size_t ch = 0; ch < num_candidates; ch++) {
+        fo_stream_channel_t* channel = &(*stream)->channels[ch];
+        free_vector(channel->filter);
+        for (size_t kind = 0; kind < ZEROCROSS_KINDS; kind++) {
+            REIM_FREE(channel->events[kind].start);
+            REIM_FREE(channel->events[kind].interval);
+        }
+    }
+    REIM_FREE((*stream)->channels);
+    destroy_decimator(&(*stream)->decimator);
+    free_vector((*stream)->input);
+    free_vector((*stream)->history);
+    REIM_FREE(*stream);
+    *stream = NULL;
+}
+
+// Remove the oldest interval from the events and the statistics
+static void pop_fo_event(zerocross_stats_t* stats, fo_events_t* events, double fs)
+{
+    const double interval = events->interval[events->head];
+    const double freq = fs / interval;
+    stats->denominator -= interval;
+    stats->sum_freq -= freq * interval;
+    stats->sum_square_freq -= freq * freq * interval;
+    events->head = (events->head + 1) % events->capacity;
+    events->count--;
+}
+
+// Add the interval ending at the new event to the events and the statistics
+static void push_fo_event(zerocross_stats_t* stats, fo_events_t* events, double position, double fs)
+{
+    if (events->last >= 0.0) {
+        if (events->count == events->capacity) {
+            pop_fo_event(stats, events, fs);
+        }
+        const size_t tail = (events->head + events->count) % events->capacity;
+        events->start[tail] = events->last;
+        events->interval[tail] = position - events->last;
+        events->count++;
+    }
+    add_zerocross_interval(stats, &events->last, position, fs);
+}
+
+static void push_fo_stream_channel(fo_stream_channel_t* channel, const real_t* history, double fs)
+{
+    // LPF (the last channel->length samples of the history)
+    double sum = 0.0;
+    for (size_t i = 0; i < channel->length; i++) {
+        sum += channel->filter[i] * history[i];
+    }
+    const real_t y = (real_t)sum;
+
+    // events around the previous sample
+    if (channel->position >= 2) {
+        double positions[ZEROCROSS_KINDS];
+        find_zerocross_events(channel->filtered[0], channel->filtered[1], y, channel->position - 1, positions);
+        for (size_t kind = 0; kind < ZEROCROSS_KINDS; kind++) {
+            if (positions[kind] >= 0.0) {
+                push_fo_event(&channel->stats, &channel->events[kind], positions[kind], fs);
+            }
+        }
+    }
+    channel->filtered[0] = channel->filtered[1];
+    channel->filtered[1] = y;
+    channel->position++;
+}
+
+// Drop the intervals out of the analysis window, then estimate fo from the rest
+static bool analyze_fo_with_stream(fo_stream_channel_t* channel, double fs, double* result_fo, double* result_rsd)
+{
+    const double window_start = (double)channel->position - (double)channel->window;
+    size_t count = 0;
+    for (size_t kind = 0; kind < ZEROCROSS_KINDS; kind++) {
+        fo_events_t* events = &channel->events[kind];
+        while (events->count > 0 && events->start[events->head] < window_start) {
+            pop_fo_event(&channel->stats, events, fs);
+        }
+        count += events->count;
+    }
+
+    // clear the rounding errors of the running sums
+    if (count == 0) {
+        channel->stats.denominator = 0.0;
+        channel->stats.sum_freq = 0.0;
+        channel->stats.sum_square_freq = 0.0;
+    }
+
+    return get_zerocross_fo(&channel->stats, fs, result_fo, result_rsd);
+}
+
+static fo_context_t* create_fo_context_with_factor(vocoder_context_t* vocoder, size_t factor, bool streaming)
+{
+    fo_context_t* context = REIM_ALLOC_SINGLE(fo_context_t);
+    const double fo_floor = vocoder->fo_floor;
+    const double fo_ceil = vocoder->fo_ceil;
+
+    // analysis rate and FFT size (the longest supported one within the frame)
+    context->decimator = NULL;
+    context->frame = NULL;
+    context->decimated = NULL;
+    context->fs = vocoder->fs;
+    context->fftsize = vocoder->fftsize;
+    if (factor > 1) {
+        context->fs = vocoder->fs / factor;
+        context->fftsize = vocoder->fftsize / factor;
+        while (!is_supported_fftsize(context->fftsize)) {
+            context->fftsize--;
+        }
+        context->decimator = create_decimator(factor);
+        context->frame = allocate_vector(vocoder->fftsize + 1);
+        context->decimated = allocate_vector(context->fftsize + 1);
+    }
+    context->numbins = context->fftsize / 2 + 1;
+    context->rfft = create_rfft(context->fftsize);
+    const double fs = context->fs;
+    const size_t fftsize = context->fftsize;
+    const size_t numbins = context->numbins;
+
+    // DIO settings
+    const double channels_per_octave = 2;
+    const size_t num_candidates = (size_t)ceil(log2(fo_ceil / fo_floor) * channels_per_octave);
+    context->num_candidates = num_candidates;
+
+    if (streaming) {
+        context->channels = NULL;
+        context->stream = create_fo_stream(vocoder, context, channels_per_octave);
+    } else {
+        context->channels = create_fo_channels(context, fo_floor, channels_per_octave);
+        context->stream = NULL;
     }
-    free_vector(xr);
-    free_vector(xi);
 
     // analysis window
     const double window_length = MIN(4.0 * fs / fo_floor, fftsize);
@@ -179,16 +500,12 @@ fo_context_t* create_fo_context(vocoder_context_t *vocoder)
     }
 
     // allocate buffers
-    context->spec_r = allocate_vector(fftsize);
-    context->spec_i = allocate_vector(fftsize);
-    context->specd_r = allocate_vector(fftsize);
-    context->specd_i = allocate_vector(fftsize);
+    context->spec = REIM_ALLOC(numbins, complex_t);
+    context->specd = REIM_ALLOC(numbins, complex_t);
     context->pspec = allocate_vector(numbins);
     context->ifreqf = allocate_vector(numbins);
-    context->spec_filt_r = allocate_vector(fftsize);
-    context->spec_filt_i = allocate_vector(fftsize);
-    context->filtered_r = allocate_vector(fftsize);
-    context->filtered_i = allocate_vector(fftsize);
+    context->ifreqf_ready = REIM_ALLOC(numbins, bool);
+    context->spec_filt = streaming ? NULL : REIM_ALLOC(numbins, complex_t);
 
     // previous fo
     context->fo_previous = 0;
@@ -196,86 +513,147 @@ fo_context_t* create_fo_context(vocoder_context_t *vocoder)
     return context;
 }
 
+fo_context_t* create_fo_context(vocoder_context_t* vocoder)
+{
+    return create_fo_context_with_factor(vocoder, 1, false);
+}
+
+fo_context_t* create_fo_context_decimated(vocoder_context_t* vocoder, double fs_analysis)
+{
+    assert(fs_analysis > 6 * vocoder->fo_ceil);
+    const size_t factor = (size_t)MAX(floor(vocoder->fs / fs_analysis), 1);
+    return create_fo_context_with_factor(vocoder, factor, false);
+}
+
+fo_context_t* create_fo_context_streaming(vocoder_context_t* vocoder)
+{
+    return create_fo_context_with_factor(vocoder, 1, true);
+}
+
 void destroy_fo_context(fo_context_t** context)
 {
-    free_matrix((*context)->channel_filters, (*context)->num_candidates);
-    REIM_FREE((*context)->channel_offsets);
+    if ((*context)->stream != NULL) {
+        destroy_fo_stream(&(*context)->stream, (*context)->num_candidates);
+    } else {
+        for (size_t ch = 0; ch < (*context)->num_candidates; ch++) {
+            fo_channel_t* channel = &(*context)->channels[ch];
+            free_vector(channel->filter);
+            REIM_FREE(channel->data);
+            destroy_irfft(&channel->ifft);
+        }
+        REIM_FREE((*context)->channels);
+    }
     free_vector((*context)->window);
+    destroy_rfft(&(*context)->rfft);
+    if ((*context)->decimator != NULL) {
+        destroy_decimator(&(*context)->decimator);
+        free_vector((*context)->frame);
+        free_vector((*context)->decimated);
+    }
 
-    free_vector((*context)->spec_r);
-    free_vector((*context)->spec_i);
-    free_vector((*context)->specd_r);
-    free_vector((*context)->specd_i);
+    REIM_FREE((*context)->spec);
+    REIM_FREE((*context)->specd);
     free_vector((*context)->pspec);
     free_vector((*context)->ifreqf);
-    free_vector((*context)->spec_filt_r);
-    free_vector((*context)->spec_filt_i);
-    free_vector((*context)->filtered_r);
-    free_vector((*context)->filtered_i);
+    REIM_FREE((*context)->ifreqf_ready);
+    REIM_FREE((*context)->spec_filt);
 
     REIM_FREE(*context);
     *context = NULL;
 }
 
-double analyze_fo(vocoder_context_t* vocoder, fo_context_t* context, const double* input, const double* input_delayed)
+// Apply LPF in frequency domain, then go back to time domain at the decimated rate and analyze zerocross
+static bool analyze_fo_with_channel(fo_channel_t* channel, const complex_t* spec_filt, double* result_fo, double* result_rsd)
+{
+    for (size_t k = 0; k < channel->passbins; k++) {
+        channel->data[k].re = spec_filt[k].re * channel->filter[k];
+        channel->data[k].im = spec_filt[k].im * channel->filter[k];
+    }
+    for (size_t k = channel->passbins; k < channel->numbins; k++) {
+        channel->data[k].re = 0.0;
+        channel->data[k].im = 0.0;
+    }
+    execute_irfft_inplace(channel->ifft, channel->data);
+
+    const real_t* filtered = (const real_t*)channel->data;
+    return analyze_fo_with_zerocross(filtered + channel->offset, channel->fftsize - channel->offset, channel->fs, result_fo, result_rsd);
+}
+
+// Task of the pool: one DIO channel (each channel has its own buffer and IFFT)
+static void analyze_fo_channel_task(void* userdata, size_t index)
 {
-    const double fs = vocoder->fs;
+    fo_context_t* context = (fo_context_t*)userdata;
+    fo_channel_t* channel = &context->channels[index];
+    channel->found = analyze_fo_with_channel(channel, context->spec_filt, &channel->fo, &channel->rsd);
+}
+
+static double analyze_fo_frame(vocoder_context_t* vocoder, fo_context_t* context, const real_t* input, const real_t* input_delayed,
+    worker_pool_t* pool)
+{
+    const double fs = context->fs;
     const double fo_floor = vocoder->fo_floor;
     const double fo_ceil = vocoder->fo_ceil;
-    const size_t fftsize = vocoder->fftsize;
-    const size_t numbins = vocoder->numbins;
+    const size_t fftsize = context->fftsize;
+    const size_t numbins = context->numbins;
 
     // spectrum
-    for (size_t k = 0; k < fftsize; k++) {
-        context->spec_r[k] = input[k] * context->window[k];
-        context->spec_i[k] = 0.0;
-        context->specd_r[k] = input_delayed[k] * context->window[k];
-        context->specd_i[k] = 0.0;
+    real_t* waveform = (real_t*)context->spec;
+    real_t* waveform_delayed = (real_t*)context->specd;
+    for (size_t i = 0; i < fftsize; i++) {
+        waveform[i] = input[i] * context->window[i];
+        waveform_delayed[i] = input_delayed[i] * context->window[i];
     }
-    execute_fft(vocoder->fft, context->spec_r, context->spec_i);
-    execute_fft(vocoder->fft, context->specd_r, context->specd_i);
+    execute_rfft_inplace(context->rfft, context->spec);
 
+    // power spectrum
     for (size_t k = 0; k < numbins; k++) {
-        // power spectrum
-        context->pspec[k] = COMPLEX_ABS2(context->spec_r[k], context->spec_i[k]) + 1e-15;
-        // instantaneous frequency
-        context->ifreqf[k] = INSTFREQ(context->spec_r[k], context->spec_i[k], context->specd_r[k], context->specd_i[k], fs);
+        const complex_t x = context->spec[k];
+        context->pspec[k] = COMPLEX_ABS2(x.re, x.im) + 1e-15;
     }
 
-    // spectrum for filtering
-    double mean_input = 0;
-    for (size_t k = 0; k < fftsize; k++) {
-        mean_input += input[k];
+    // the delayed spectrum and the instantaneous frequency are left to refine_fo()
+    context->specd_ready = false;
+    for (size_t k = 0; k < numbins; k++) {
+        context->ifreqf_ready[k] = false;
     }
-    mean_input /= fftsize;
-    for (size_t k = 0; k < fftsize; k++) {
-        context->spec_filt_r[k] = input[k] - mean_input;
-        context->spec_filt_i[k] = 0.0;
+
+    // spectrum for filtering (DIO on each frame)
+    if (context->stream == NULL) {
+        double mean_input = 0;
+        for (size_t k = 0; k < fftsize; k++) {
+            mean_input += input[k];
+        }
+        mean_input /= fftsize;
+        real_t* waveform_filt = (real_t*)context->spec_filt;
+        for (size_t i = 0; i < fftsize; i++) {
+            waveform_filt[i] = input[i] - mean_input;
+        }
+        execute_rfft_inplace(context->rfft, context->spec_filt);
+
+        // candidates of all the channels (refine_fo() below evaluates the shared spectra lazily, so it stays serial)
+        run_worker_pool(pool, analyze_fo_channel_task, context, context->num_candidates);
     }
-    execute_fft(vocoder->fft, context->spec_filt_r, context->spec_filt_i);
 
     // initial estimate: previous fo
     double best_fo = -1;
     double best_score = -1;
     if (context->fo_previous > fo_floor) {
-        best_fo = refine_fo(context->fo_previous, fo_floor, fo_ceil, fs, context->ifreqf, context->pspec, numbins);
+        best_fo = refine_fo(context, context->fo_previous, fo_floor, fo_ceil);
         best_score = get_harmonic_score(best_fo, fs, context->pspec, numbins);
     }
 
     // DIO (Distributed Inline Operation)
     for (size_t ch = 0; ch < context->num_candidates; ch++) {
-        // apply LPF in frequency domain
-        for (size_t k = 0; k < fftsize; k++) {
-            const double filter = context->channel_filters[ch][k];
-            context->filtered_r[k] = context->spec_filt_r[k] * filter;
-            context->filtered_i[k] = context->spec_filt_i[k] * filter;
-        }
-        execute_ifft(vocoder->ifft, context->filtered_r, context->filtered_i);
-
-        // analyze zerocross
-        const size_t offset = context->channel_offsets[ch];
         double fo = 0, rsd = 0;
-        if (!analyze_fo_with_zerocross(context->filtered_r + offset, fftsize - offset, fs, &fo, &rsd)) {
+        bool found;
+        if (context->stream != NULL) {
+            found = analyze_fo_with_stream(&context->stream->channels[ch], context->stream->fs, &fo, &rsd);
+        } else {
+            found = context->channels[ch].found;
+            fo = context->channels[ch].fo;
+            rsd = context->channels[ch].rsd;
+        }
+        if (!found) {
             continue;
         }
         if (isnan(fo) || fo < fo_floor || fo > fo_ceil || rsd > 1.0) {
@@ -283,7 +661,7 @@ double analyze_fo(vocoder_context_t* vocoder, fo_context_t* context, const doubl
         }
 
         // refine fo
-        const double fo_refined = refine_fo(fo, fo_floor, fo_ceil, fs, context->ifreqf, context->pspec, numbins);
+        const double fo_refined = refine_fo(context, fo, fo_floor, fo_ceil);
 
         // score (higher is better)
         const double score = get_harmonic_score(fo_refined, fs, context->pspec, numbins);
@@ -304,3 +682,88 @@ double analyze_fo(vocoder_context_t* vocoder, fo_context_t* context, const doubl
 
     return best_fo;
 }
+
+double analyze_fo(vocoder_context_t* vocoder, fo_context_t* context, const real_t* input, const real_t* input_delayed)
+{
+    return analyze_fo_with_pool(vocoder, context, input, input_delayed, NULL);
+}
+
+double analyze_fo_with_pool(vocoder_context_t* vocoder, fo_context_t* context, const real_t* input, const real_t* input_delayed, worker_pool_t* pool)
+{
+    if (context->decimator == NULL) {
+        return analyze_fo_frame(vocoder, context, input, input_delayed, pool);
+    }
+
+    // decimate the frame with the one-sample-delayed sample,
+    // then the decimated frame and its one-sample-delayed one overlap in the same way (centered in the frame)
+    const size_t length = vocoder->fftsize + 1;
+    const size_t factor = context->decimator->factor;
+    context->frame[0] = input_delayed[0];
+    for (size_t i = 0; i < vocoder->fftsize; i++) {
+        context->frame[i + 1] = input[i];
+    }
+    const size_t offset = (length - 1 - context->fftsize * factor) / 2;
+    execute_decimator(context->decimator, context->frame, length, offset, context->decimated, context->fftsize + 1);
+
+    return analyze_fo_frame(vocoder, context, context->decimated + 1, context->decimated, pool);
+}
+
+void push_fo_stream(fo_context_t* context, real_t input)
+{
+    fo_stream_t* stream = context->stream;
+    assert(stream != NULL);
+
+    // input history (mirrored, then the last samples are contiguous from the head)
+    const size_t length = stream->decimator->length;
+    stream->input[stream->input_head] = input;
+    stream->input[stream->input_head + length] = input;
+    stream->input_head = (stream->input_head + 1) % length;
+    if (++stream->phase < stream->decimator->factor) {
+        return;
+    }
+    stream->phase = 0;
+
+    // decimate the last samples and remove DC
+    real_t x;
+    execute_decimator(stream->decimator, stream->input + stream->input_head, length, stream->decimator->half, &x, 1);
+    stream->dc_output = x - stream->dc_input + stream->dc_coef * stream->dc_output;
+    stream->dc_input = x;
+
+    // stream history (mirrored)
+    const size_t history_length = stream->history_length;
+    stream->history[stream->history_head] = (real_t)stream->dc_output;
+    stream->history[stream->history_head + history_length] = (real_t)stream->dc_output;
+    stream->history_head = (stream->history_head + 1) % history_length;
+
+    // LPF and events of each channel
+    const real_t* history_end = stream->history + stream->history_head + history_length;
+    for (size_t ch = 0; ch < context->num_candidates; ch++) {
+        fo_stream_channel_t* channel = &stream->channels[ch];
+        push_fo_stream_channel(channel, history_end - channel->length, stream->fs);
+    }
+}
+
+bool get_fo_candidate(const fo_context_t* context, size_t channel, double* fo, double* rsd)
+{
+    assert(channel < context->num_candidates);
+    if (context->stream != NULL) {
+        return get_zerocross_fo(&context->stream->channels[channel].stats, context->stream->fs, fo, rsd);
+    }
+    const fo_channel_t* ch = &context->channels[channel];
+    *fo = ch->fo;
+    *rsd = ch->rsd;
+    return ch->found;
+}
+
+size_t get_fo_stream_intervals(const fo_context_t* context, size_t channel)
+{
+    assert(channel < context->num_candidates);
+    if (context->stream == NULL) {
+        return 0;
+    }
+    size_t count = 0;
+    for (size_t kind = 0; kind < ZEROCROSS_KINDS; kind++) {
+        count += context->stream->channels[channel].events[kind].count;
+    }
+    return count;
+}
@@ -2,6 +2,8 @@
 
 #include "reim/mathematics.h"
 #include "reim/memory.h"
+#include "reim/vmath.h"
+#include <assert.h>
 
 static double hanning_window(double index, double fftsize, double length)
 {
@@ -11,40 +13,88 @@ static double hanning_window(double index, double fftsize, double length)
     return 0.5 + 0.5 * cos(wt);
 }
 
-static void apply_replica(double* pspec, size_t numbins, double fo, double fs)
+// Length of the analysis window of the fo
+static double get_window_length(size_t fftsize, double fo, double fs)
+{
+    return MIN(3.0 * (fs / fo), fftsize);
+}
+
+// First non-zero sample of the window: |2 i - (fftsize - 1)| < length
+static size_t get_window_offset(size_t fftsize, double length)
+{
+    return (size_t)MAX(floor((fftsize - 1 - length) / 2) + 1, 0.0);
+}
+
+// Analysis window on the non-zero samples (buffer: fftsize - 2 * offset)
+static void set_window(sp_window_t* window, real_t* buffer, size_t fftsize, double fo, double fs)
+{
+    const double analysis_interval = fs / fo;
+    const double length = get_window_length(fftsize, fo, fs);
+    const double scale = 1.0 / sqrt(analysis_interval);
+    window->offset = get_window_offset(fftsize, length);
+    window->length = fftsize - 2 * window->offset;
+    window->window = buffer;
+    window->sum = 0.0;
+    for (size_t i = 0; i < window->length; i++) {
+        buffer[i] = hanning_window(window->offset + i, fftsize, length) * scale;
+        window->sum += buffer[i];
+    }
+}
+
+static void create_window(sp_window_t* window, size_t fftsize, double fo, double fs)
+{
+    const size_t offset = get_window_offset(fftsize, get_window_length(fftsize, fo, fs));
+    set_window(window, allocate_vector(fftsize - 2 * offset), fftsize, fo, fs);
+}
+
+// Sinc lifter of the fo (including the normalization of the IFFT)
+static void set_lifter(real_t* lifter, size_t numbins, double fo, double fs)
+{
+    const size_t fftsize = 2 * (numbins - 1);
+    const double q = -0.15;
+    for (size_t k = 0; k < numbins; k++) {
+        const double t = k * fo / fs;
+        const double sinct = sin(REIM_PI * t + 1e-12) / (REIM_PI * t + 1e-12);
+        lifter[k] = sinct * ((1.0 - 2.0 * q) + 2.0 * q * cos(2.0 * REIM_PI * t)) / fftsize;
+    }
+}
+
+static void apply_replica(real_t* pspec, size_t numbins, double fo, double fs)
 {
     size_t fftsize = 2 * (numbins - 1);
 
     // replicate the spectrum for DC component
+    // (negative frequencies are read from the mirrored bins)
     size_t fobin = 1 + round(fo / (fs / 2) * (numbins - 1));
     for (size_t k = 0; k < fobin; k++) {
-        pspec[k] += pspec[fftsize - fobin - k];
-    }
-
-    // copy to the last half
-    for (size_t k = 0; k < numbins - 2; k++) {
-        pspec[numbins + k] = pspec[numbins - 2 - k];
+        const size_t index = fobin + k;
+        pspec[k] += pspec[(index < numbins) ? index : fftsize - index];
     }
 }
 
-static void smooth_spectrum(double* pspec, double* spec_cumsum, size_t numbins, double freq_range, double fs)
+static void smooth_spectrum(real_t* pspec, double* spec_cumsum, size_t numbins, double freq_range, double fs)
 {
     size_t fftsize = 2 * (numbins - 1);
 
-    // cumulative summation of spectrum
+    const double half_range = freq_range / fs * (numbins - 1);
+    const size_t half_range_int = (size_t)floor(half_range);
+    const double half_range_frc = half_range - half_range_int;
+
+    // cumulative summation of spectrum (mirrored to the negative frequencies)
     const size_t offset = numbins - 2;
-    spec_cumsum[0] = pspec[numbins];
+    const size_t length = MIN(numbins + half_range_int, fftsize);
+    spec_cumsum[0] = pspec[offset];
     for (size_t k = 1; k < offset; k++) {
-        spec_cumsum[k] = pspec[numbins + k] + spec_cumsum[k - 1];
+        spec_cumsum[k] = pspec[offset - k] + spec_cumsum[k - 1];
     }
-    for (size_t k = 0; k < fftsize; k++) {
+    for (size_t k = 0; k < numbins; k++) {
         spec_cumsum[offset + k] = pspec[k] + spec_cumsum[offset + k - 1];
     }
+    for (size_t k = numbins; k < length; k++) {
+        spec_cumsum[offset + k] = pspec[fftsize - k] + spec_cumsum[offset + k - 1];
+    }
 
     // moving average of the spectrum
-    const double half_range = freq_range / fs * (numbins - 1);
-    const size_t half_range_int = (size_t)floor(half_range);
-    const double half_range_frc = half_range - half_range_int;
     for (size_t k = 0; k < numbins; k++) {
         const size_t index_upper = offset + k + half_range_int;
         const size_t index_lower = offset + k - half_range_int;
@@ -52,47 +102,42 @@ static void smooth_spectrum(double* pspec, double* spec_cumsum, size_t numbins,
         const double lower = (1.0 - half_range_frc) * spec_cumsum[index_lower] + half_range_frc * spec_cumsum[index_lower - 1];
         pspec[k] = MAX(upper - lower, 1e-12) / (2.0 * half_range);
     }
-
-    // copy to the last half
-    for (size_t k = 0; k < numbins - 2; k++) {
-        pspec[numbins + k] = pspec[numbins - 2 - k];
-    }
 }
 
-static void lifter_spectrum(double* pspec, double* imag, size_t numbins, double fo, double fs, fft_t* fft, ifft_t* ifft)
+// The output is the log power spectrum if logarithmic is true, otherwise the power spectrum
+// The log spectrum and the cepstrum are even, so the transforms are the DCT-I of the half.
+static void lifter_spectrum(real_t* pspec, real_t* cepstrum, size_t numbins, const real_t* lifter, bool logarithmic,
+    const dct_t* dct, complex_t* scratch)
 {
-    size_t fftsize = 2 * (numbins - 1);
-
     // cepstrum
-    for (size_t k = 0; k < fftsize; k++) {
-        pspec[k] = log(pspec[k] + 1e-12);
-        imag[k] = 0.0;
+    for (size_t k = 0; k < numbins; k++) {
+        cepstrum[k] = pspec[k] + 1e-12;
     }
-    execute_ifft(ifft, pspec, imag);
+    vlog(cepstrum, cepstrum, numbins);
+    execute_dct_inplace_with_scratch(dct, cepstrum, scratch);
 
     // sinc liftering
-    const double q = -0.15;
     for (size_t k = 0; k < numbins; k++) {
-        const double t = k * fo / fs;
-        const double sinct = sin(REIM_PI * t + 1e-12) / (REIM_PI * t + 1e-12);
-        pspec[k] *= sinct * ((1.0 - 2.0 * q) + 2.0 * q * cos(2.0 * REIM_PI * t));
-        imag[k] = 0.0;
-    }
-    for (size_t k = 0; k < numbins - 2; k++) {
-        pspec[numbins + k] = pspec[numbins - 2 - k];
-        imag[numbins + k] = 0.0;
+        cepstrum[k] *= lifter[k];
     }
 
     // power spectrum
-    execute_fft(fft, pspec, imag);
-    for (size_t k = 0; k < numbins; k++) {
-        pspec[k] = exp(pspec[k]);
-    }
-    for (size_t k = 0; k < numbins - 2; k++) {
-        pspec[numbins + k] = pspec[numbins - 2 - k];
+    execute_dct_inplace_with_scratch(dct, cepstrum, scratch);
+    if (logarithmic) {
+        for (size_t k = 0; k < numbins; k++) {
+            pspec[k] = cepstrum[k];
+        }
+    } else {
+        vexp(cepstrum, pspec, numbins);
     }
 }
 
+// fo of the unvoiced frames (the window of the frame period)
+static double get_unvoiced_fo(const vocoder_context_t* vocoder)
+{
+    return 1.0 / (vocoder->period / 1000.0);
+}
+
 sp_context_t* create_sp_context(vocoder_context_t* vocoder)
 {
     const size_t fftsize = vocoder->fftsize;
@@ -100,80 +145,141 @@ sp_context_t* create_sp_context(vocoder_context_t* vocoder)
 
     sp_context_t* context = REIM_ALLOC_SINGLE(sp_context_t);
     context->window = allocate_vector(fftsize);
-    context->x_real = allocate_vector(fftsize);
-    context->x_imag = allocate_vector(fftsize);
-    context->pspec = allocate_vector(fftsize);
-    context->spec_cumsum = allocate_vector(numbins + fftsize);
+    context->lifter = allocate_vector(numbins);
+    context->spec = REIM_ALLOC(numbins, complex_t);
+    context->pspec = allocate_vector(numbins);
+    context->spec_cumsum = REIM_ALLOC(numbins + fftsize, double);
+    context->scratch = allocate_fft_scratch(get_vocoder_scratch_length(vocoder));
+    create_window(&context->window_unvoiced, fftsize, get_unvoiced_fo(vocoder), vocoder->fs);
+
+    context->table_size = 0;
+    context->entries_per_octave = 0.0;
+    context->table_fo_floor = 0.0;
+    context->table_window = NULL;
+    context->table_lifter = NULL;
+    return context;
+}
+
+sp_context_t* create_sp_context_tabulated(vocoder_context_t* vocoder, double entries_per_octave)
+{
+    assert(entries_per_octave > 0);
+
+    const size_t numbins = vocoder->numbins;
+    sp_context_t* context = create_sp_context(vocoder);
+    context->table_size = (size_t)ceil(log2(vocoder->fo_ceil / vocoder->fo_floor) * entries_per_octave) + 1;
+    context->entries_per_octave = entries_per_octave;
+    context->table_fo_floor = vocoder->fo_floor;
+    context->table_window = REIM_ALLOC(context->table_size, sp_window_t);
+    context->table_lifter = allocate_vector(context->table_size * numbins);
+    for (size_t i = 0; i < context->table_size; i++) {
+        const double fo = vocoder->fo_floor * pow(2.0, i / entries_per_octave);
+        create_window(&context->table_window[i], vocoder->fftsize, fo, vocoder->fs);
+        set_lifter(context->table_lifter + i * numbins, numbins, fo, vocoder->fs);
+    }
     return context;
 }
 
 void destroy_sp_context(sp_context_t** context)
 {
+    for (size_t i = 0; i < (*context)->table_size; i++) {
+        free_vector((*context)->table_window[i].window);
+    }
+    REIM_FREE((*context)->table_window);
+    free_vector((*context)->table_lifter);
+    free_vector((*context)->window_unvoiced.window);
     free_vector((*context)->window);
-    free_vector((*context)->x_real);
-    free_vector((*context)->x_imag);
+    free_vector((*context)->lifter);
+    REIM_FREE((*context)->spec);
     free_vector((*context)->pspec);
-    free_vector((*context)->spec_cumsum);
+    REIM_FREE((*context)->spec_cumsum);
+    free_fft_scratch((*context)->scratch);
     REIM_FREE(*context);
     *context = NULL;
 }
 
-void analyze_sp(vocoder_context_t* vocoder, sp_context_t* context, const double* input, double fo, bool isvoiced, bool issilence, double* sp)
+// Nearest entry of the table (table_size if the fo is out of the table)
+static size_t find_table_entry(const sp_context_t* context, double fo)
+{
+    if (context->table_size == 0) {
+        return 0;
+    }
+    const double position = floor(log2(fo / context->table_fo_floor) * context->entries_per_octave + 0.5);
+    return (position >= 0.0 && position < context->table_size) ? (size_t)position : context->table_size;
+}
+
+static void analyze_sp_with_scale(vocoder_context_t* vocoder, sp_context_t* context, const real_t* input,
+    double fo, bool isvoiced, bool issilence, bool logarithmic, real_t* sp)
 {
     const double fs = vocoder->fs;
     const size_t fftsize = vocoder->fftsize;
     const size_t numbins = vocoder->numbins;
 
-    const double window_fo = (isvoiced ? fo : 1.0 / (vocoder->period / 1000.0));
+    const double window_fo = (isvoiced ? fo : get_unvoiced_fo(vocoder));
     const double smooth_fo = (isvoiced ? fo : 300.0);
 
     // don't estimate when silence
     if (issilence) {
+        const double floor = logarithmic ? log(1e-12) : 1e-12;
         for (size_t k = 0; k < numbins; k++) {
-            sp[k] = 1e-12;
+            sp[k] = floor;
         }
         return;
     }
 
-    // analysis windowing
-    const double analysis_interval = fs / window_fo;
-    const double window_length = MIN(3.0 * analysis_interval, fftsize);
-    const double window_scale = 1.0 / sqrt(analysis_interval);
-    for (size_t i = 0; i < fftsize; i++) {
-        context->window[i] = hanning_window(i, fftsize, window_length) * window_scale;
-        context->x_real[i] = input[i] * context->window[i];
-        context->x_imag[i] = 0.0;
+    // window and lifter of the frame (from the table if available)
+    sp_window_t frame_window;
+    const sp_window_t* window = &context->window_unvoiced;
+    const real_t* lifter = context->lifter;
+    if (isvoiced) {
+        const size_t entry = find_table_entry(context, fo);
+        if (entry < context->table_size) {
+            window = &context->table_window[entry];
+            lifter = context->table_lifter + entry * numbins;
+        } else {
+            set_window(&frame_window, context->window, fftsize, window_fo, fs);
+            set_lifter(context->lifter, numbins, smooth_fo, fs);
+            window = &frame_window;
+        }
     }
 
-    // remove DC component
-    double sum_x = 0.0, sum_window = 0.0;
-    for (size_t i = 0; i < fftsize; i++) {
-        sum_x += context->x_real[i];
-        sum_window += context->window[i];
+    // analysis windowing (only the non-zero samples)
+    real_t* waveform = (real_t*)context->spec;
+    const size_t offset = window->offset;
+    const size_t length = window->length;
+    for (size_t i = 0; i < offset; i++) {
+        waveform[i] = 0.0;
+        waveform[fftsize - 1 - i] = 0.0;
     }
-    const double gain_dc = sum_x / sum_window;
-    for (size_t i = 0; i < fftsize; i++) {
-        context->x_real[i] -= gain_dc * context->window[i];
+    double sum_x = 0.0;
+    for (size_t i = 0; i < length; i++) {
+        waveform[offset + i] = input[offset + i] * window->window[i];
+        sum_x += waveform[offset + i];
     }
 
-    // power spectrum
-    execute_fft(vocoder->fft, context->x_real, context->x_imag);
-    for (size_t k = 0; k < numbins; k++) {
-        context->pspec[k] = COMPLEX_ABS2(context->x_real[k], context->x_imag[k]);
-    }
-    for (size_t k = 0; k < numbins - 2; k++) {
-        context->pspec[numbins + k] = context->pspec[numbins - 2 - k];
+    // remove DC component
+    const double gain_dc = sum_x / window->sum;
+    for (size_t i = 0; i < length; i++) {
+        waveform[offset + i] -= gain_dc * window->window[i];
     }
 
+    // power spectrum
+    execute_rfft_inplace_with_scratch(vocoder->rfft, context->spec, context->scratch);
+    vabs2(context->spec, context->pspec, numbins);
+
     // DC replication
     apply_replica(context->pspec, numbins, window_fo, fs);
 
     // smoothing
     smooth_spectrum(context->pspec, context->spec_cumsum, numbins, smooth_fo / 2, fs);
 
-    // liftering
+    // liftering (the output is already logarithmic if needed)
     if (isvoiced) {
-        lifter_spectrum(context->pspec, context->x_imag, numbins, smooth_fo, fs, vocoder->fft, vocoder->ifft);
+        lifter_spectrum(context->pspec, (real_t*)context->spec, numbins, lifter, logarithmic, vocoder->dct, context->scratch);
+    } else if (logarithmic) {
+        for (size_t k = 0; k < numbins; k++) {
+            context->pspec[k] += 1e-12;
+        }
+        vlog(context->pspec, context->pspec, numbins);
     }
 
     // copy
@@ -181,3 +287,13 @@ void analyze_sp(vocoder_context_t* vocoder, sp_context_t* context, const double*
         sp[k] = context->pspec[k];
     }
 }
+
+void analyze_sp(vocoder_context_t* vocoder, sp_context_t* context, const real_t* input, double fo, bool isvoiced, bool issilence, real_t* sp)
+{
+    analyze_sp_with_scale(vocoder, context, input, fo, isvoiced, issilence, false, sp);
+}
+
+void analyze_sp_log(vocoder_context_t* vocoder, sp_context_t* context, const real_t* input, double fo, bool isvoiced, bool issilence, real_t* sp_log)
+{
+    analyze_sp_with_scale(vocoder, context, input, fo, isvoiced, issilence, true, sp_log);
+}
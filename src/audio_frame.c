@@ -25,22 +25,16 @@ void destroy_audio_frame(audio_frame_t** frame)
     *frame = NULL;
 }
 
-bool next_audio_frame(audio_frame_t* frame, double input, double* frame_waveform)
+// Advance the position by the one sample, returns true when a new frame starts at the sample
+static bool next_position(audio_frame_t* frame)
 {
-    push_circular_buffer(frame->buffer_in, input);
-
     const double position = frame->position;
-    const size_t position_int = (size_t)floor(position);
 
     // a new frame is available when the position reaches at the beginning of the frame
-    bool has_new_frame = (position_int == 0);
+    bool has_new_frame = (position < 1.0);
     if (has_new_frame) {
-        // copy to the frame waveform buffer
-        copy_all_circular_buffer(frame->buffer_in, frame_waveform);
-
-        // calculate the number of the samples to output
-        const double position_frac = position - position_int;
-        frame->outputsize = (size_t)floor(frame->framesize + position_frac);
+        // calculate the number of the samples to output (the position is the fractional part)
+        frame->outputsize = (size_t)floor(frame->framesize + position);
     }
 
     // update the position in the current frame
@@ -52,3 +46,33 @@ bool next_audio_frame(audio_frame_t* frame, double input, double* frame_waveform
 
     return has_new_frame;
 }
+
+bool next_audio_frame(audio_frame_t* frame, real_t input, real_t* frame_waveform)
+{
+    push_circular_buffer(frame->buffer_in, input);
+
+    const bool has_new_frame = next_position(frame);
+    if (has_new_frame) {
+        // copy to the frame waveform buffer
+        copy_all_circular_buffer(frame->buffer_in, frame_waveform);
+    }
+    return has_new_frame;
+}
+
+size_t next_audio_frame_block(audio_frame_t* frame, const real_t* input, size_t length, bool* has_new_frame)
+{
+    // find the beginning of the next frame, then push the samples until there at once
+    size_t count = 0;
+    *has_new_frame = false;
+    while (count < length && !*has_new_frame) {
+        *has_new_frame = next_position(frame);
+        count++;
+    }
+    push_block_circular_buffer(frame->buffer_in, input, count);
+    return count;
+}
+
+const real_t* get_audio_frame(const audio_frame_t* frame)
+{
+    return get_all_circular_buffer(frame->buffer_in);
+}
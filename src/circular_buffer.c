@@ -1,24 +1,19 @@
 #include "reim/circular_buffer.h"
 
+#include "reim/mathematics.h"
 #include "reim/memory.h"
 #include <stdlib.h>
-
-static inline size_t next(size_t index, size_t capacity)
-{
-    index++;
-    if (index >= capacity) {
-        index = 0;
-    }
-    return index;
-}
+#include <string.h>
 
 circular_buffer_t* create_circular_buffer(size_t capacity)
 {
     circular_buffer_t* cb = REIM_ALLOC_SINGLE(circular_buffer_t);
+    const size_t size = get_next_pow2(capacity);
     cb->head = 0;
     cb->capacity = capacity;
-    cb->buffer = allocate_vector(capacity);
-    for (size_t i = 0; i < capacity; i++) {
+    cb->mask = size - 1;
+    cb->buffer = allocate_vector(2 * size);
+    for (size_t i = 0; i < 2 * size; i++) {
         cb->buffer[i] = 0.0;
     }
     return cb;
@@ -31,17 +26,44 @@ void destroy_circular_buffer(circular_buffer_t** cb)
     *cb = NULL;
 }
 
-void push_circular_buffer(circular_buffer_t* cb, double value)
+void push_circular_buffer(circular_buffer_t* cb, real_t value)
 {
-    cb->head = next(cb->head, cb->capacity);
+    const size_t size = cb->mask + 1;
+    cb->head = (cb->head + 1) & cb->mask;
     cb->buffer[cb->head] = value;
+    cb->buffer[cb->head + size] = value;
 }
 
-void copy_all_circular_buffer(circular_buffer_t* cb, double* destination)
+void push_block_circular_buffer(circular_buffer_t* cb, const real_t* values, size_t length)
 {
-    size_t index = cb->head;
-    for (size_t i = 0; i < cb->capacity; i++) {
-        index = next(index, cb->capacity);
-        destination[i] = cb->buffer[index];
+    // only the latest values remain
+    if (length > cb->capacity) {
+        values += length - cb->capacity;
+        length = cb->capacity;
+    }
+    if (length == 0) {
+        return;
     }
+
+    // two segments: until the end of the ring, then from the beginning
+    const size_t size = cb->mask + 1;
+    const size_t start = (cb->head + 1) & cb->mask;
+    const size_t length1 = MIN(length, size - start);
+    const size_t length2 = length - length1;
+    memcpy(cb->buffer + start, values, length1 * sizeof(real_t));
+    memcpy(cb->buffer + start + size, values, length1 * sizeof(real_t));
+    memcpy(cb->buffer, values + length1, length2 * sizeof(real_t));
+    memcpy(cb->buffer + size, values + length1, length2 * sizeof(real_t));
+    cb->head = (start + length - 1) & cb->mask;
+}
+
+const real_t* get_all_circular_buffer(const circular_buffer_t* cb)
+{
+    // the latest value is at (head + size) in the mirror
+    return cb->buffer + cb->head + (cb->mask + 1) - cb->capacity + 1;
+}
+
+void copy_all_circular_buffer(circular_buffer_t* cb, real_t* destination)
+{
+    memcpy(destination, get_all_circular_buffer(cb), cb->capacity * sizeof(real_t));
 }
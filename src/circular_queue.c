@@ -3,14 +3,22 @@
 #include "reim/mathematics.h"
 #include "reim/memory.h"
 #include <stdlib.h>
+#include <string.h>
 
-static inline size_t next(size_t index, size_t capacity)
+// The bulk operations are split into the two segments (until the end of the buffer, then from the beginning)
+// so that each one is a straight loop.
+static void add_vector(real_t* destination, const real_t* source, size_t size)
 {
-    index++;
-    if (index >= capacity) {
-        index = 0;
+    for (size_t i = 0; i < size; i++) {
+        destination[i] += source[i];
     }
-    return index;
+}
+
+static void clear_circular_queue(circular_queue_t* queue, size_t size)
+{
+    const size_t size1 = MIN(size, queue->capacity - queue->head);
+    memset(queue->buffer + queue->head, 0, size1 * sizeof(real_t));
+    memset(queue->buffer, 0, (size - size1) * sizeof(real_t));
 }
 
 circular_queue_t* create_circular_queue(size_t capacity)
@@ -18,9 +26,10 @@ circular_queue_t* create_circular_queue(size_t capacity)
     circular_queue_t* queue = REIM_ALLOC_SINGLE(circular_queue_t);
     queue->head = 0;
     queue->remaining = 0;
-    queue->capacity = capacity;
-    queue->buffer = allocate_vector(capacity);
-    for (size_t i = 0; i < capacity; i++) {
+    queue->capacity = get_next_pow2(capacity);
+    queue->mask = queue->capacity - 1;
+    queue->buffer = allocate_vector(queue->capacity);
+    for (size_t i = 0; i < queue->capacity; i++) {
         queue->buffer[i] = 0.0;
     }
     return queue;
@@ -38,33 +47,57 @@ size_t get_remaining_circular_queue(const circular_queue_t* queue)
     return queue->remaining;
 }
 
-void push_additive_circular_queue(circular_queue_t* queue, const double* buffer, size_t size)
+void push_additive_circular_queue(circular_queue_t* queue, const real_t* buffer, size_t size)
 {
-    size_t index = queue->head;
-    for (size_t i = 0; i < size; i++) {
-        double value = buffer[i];
-        if (i >= queue->capacity) {
-            queue->buffer[index] = value; // overwrite when overflow
-            queue->head = next(queue->head, queue->capacity);
-        } else {
-            queue->buffer[index] += value;
-        }
-        index = next(index, queue->capacity);
+    push_additive_offset_circular_queue(queue, 0, buffer, size);
+}
+
+void push_additive_offset_circular_queue(circular_queue_t* queue, size_t offset, const real_t* buffer, size_t size)
+{
+    // the values beyond the capacity push out the oldest ones (overwrite when overflow)
+    if (offset + size > queue->capacity) {
+        const size_t overflow = offset + size - queue->capacity;
+        clear_circular_queue(queue, MIN(overflow, queue->remaining));
+        queue->head = (queue->head + overflow) & queue->mask;
+        queue->remaining = (queue->remaining > overflow) ? queue->remaining - overflow : 0;
+        const size_t skipped = (overflow > offset) ? overflow - offset : 0;
+        buffer += skipped;
+        size -= skipped;
+        offset -= overflow - skipped;
     }
-    queue->remaining = CLAMP(size, queue->remaining, queue->capacity);
+
+    const size_t start = (queue->head + offset) & queue->mask;
+    const size_t size1 = MIN(size, queue->capacity - start);
+    add_vector(queue->buffer + start, buffer, size1);
+    add_vector(queue->buffer, buffer + size1, size - size1);
+    queue->remaining = MAX(queue->remaining, offset + size);
 }
 
-double pop_circular_queue(circular_queue_t* queue)
+real_t pop_circular_queue(circular_queue_t* queue)
 {
     if (queue->remaining == 0) {
         return 0.0;
     }
 
-    double value = queue->buffer[queue->head];
+    real_t value = queue->buffer[queue->head];
     queue->buffer[queue->head] = 0.0;
 
-    queue->head = next(queue->head, queue->capacity);
+    queue->head = (queue->head + 1) & queue->mask;
     queue->remaining--;
 
     return value;
 }
+
+void pop_block_circular_queue(circular_queue_t* queue, real_t* output, size_t size)
+{
+    const size_t count = MIN(size, queue->remaining);
+    const size_t count1 = MIN(count, queue->capacity - queue->head);
+    memcpy(output, queue->buffer + queue->head, count1 * sizeof(real_t));
+    memcpy(output + count1, queue->buffer, (count - count1) * sizeof(real_t));
+    clear_circular_queue(queue, count);
+    queue->head = (queue->head + count) & queue->mask;
+    queue->remaining -= count;
+
+    // the queue is empty
+    memset(output + count, 0, (size - count) * sizeof(real_t));
+}
@@ -0,0 +1,130 @@
+#include "reim/cpu.h"
+
+#include "reim/thread.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CPU_X86
+#ifdef _MSC_VER
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define CPU_NEON
+#endif
+
+static const char* const isa_names[CPU_ISA_COUNT] = { "scalar", "sse2", "avx2", "avx512", "neon" };
+
+// The detection runs once under the lock; supported[] is read only after is_detected is set.
+static mutex_t cpu_mutex = MUTEX_INITIALIZER;
+static atomic_int_t is_detected = 0;
+static bool supported[CPU_ISA_COUNT];
+
+static void detect_cpu_isa()
+{
+    if (load_atomic_int(&is_detected)) {
+        return;
+    }
+    lock_mutex(&cpu_mutex);
+    if (load_atomic_int(&is_detected)) {
+        unlock_mutex(&cpu_mutex);
+        return;
+    }
+    supported[CPU_ISA_SCALAR] = true;
+#if defined CPU_X86 && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    supported[CPU_ISA_SSE2] = __builtin_cpu_supports("sse2");
+    supported[CPU_ISA_AVX2] = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    supported[CPU_ISA_AVX512] = __builtin_cpu_supports("avx512f");
+#elif defined CPU_X86 && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    const bool has_sse2 = (info[3] & (1 << 26)) != 0;
+    const bool has_fma = (info[2] & (1 << 12)) != 0;
+    const bool has_osxsave = (info[2] & (1 << 27)) != 0;
+    const unsigned long long xcr0 = has_osxsave ? _xgetbv(0) : 0;
+    __cpuidex(info, 7, 0);
+    const bool has_avx2 = (info[1] & (1 << 5)) != 0;
+    const bool has_avx512f = (info[1] & (1 << 16)) != 0;
+    // the OS saves the YMM (and ZMM) registers
+    supported[CPU_ISA_SSE2] = has_sse2;
+    supported[CPU_ISA_AVX2] = has_avx2 && has_fma && (xcr0 & 0x6) == 0x6;
+    supported[CPU_ISA_AVX512] = has_avx512f && (xcr0 & 0xE6) == 0xE6;
+#elif defined CPU_NEON
+    supported[CPU_ISA_NEON] = true;
+#endif
+    store_atomic_int(&is_detected, 1);
+    unlock_mutex(&cpu_mutex);
+}
+
+bool is_cpu_isa_supported(cpu_isa_t isa)
+{
+    detect_cpu_isa();
+    return (unsigned)isa < CPU_ISA_COUNT && supported[isa];
+}
+
+const char* get_cpu_isa_name(cpu_isa_t isa)
+{
+    return ((unsigned)isa < CPU_ISA_COUNT) ? isa_names[isa] : "unknown";
+}
+
+// The widest supported instruction set, or REIM_ISA if it is supported
+static cpu_isa_t select_kernel_isa()
+{
+    const char* name = getenv("REIM_ISA");
+    if (name != NULL) {
+        for (int isa = 0; isa < CPU_ISA_COUNT; isa++) {
+            if (strcmp(name, isa_names[isa]) == 0 && is_cpu_isa_supported((cpu_isa_t)isa)) {
+                return (cpu_isa_t)isa;
+            }
+        }
+    }
+    const cpu_isa_t preference[] = { CPU_ISA_AVX512, CPU_ISA_AVX2, CPU_ISA_SSE2, CPU_ISA_NEON };
+    for (size_t i = 0; i < sizeof(preference) / sizeof(preference[0]); i++) {
+        if (is_cpu_isa_supported(preference[i])) {
+            return preference[i];
+        }
+    }
+    return CPU_ISA_SCALAR;
+}
+
+// CPU_ISA_COUNT: not selected yet
+// The kernels read it at each call without the lock; the writes are serialized by the lock,
+// so the default selection never overwrites set_kernel_isa().
+static atomic_int_t kernel_isa = CPU_ISA_COUNT;
+
+cpu_isa_t get_kernel_isa()
+{
+    int isa = load_atomic_int(&kernel_isa);
+    if (isa == CPU_ISA_COUNT) {
+        const cpu_isa_t selected = select_kernel_isa();
+        lock_mutex(&cpu_mutex);
+        isa = load_atomic_int(&kernel_isa);
+        if (isa == CPU_ISA_COUNT) {
+            isa = selected;
+            store_atomic_int(&kernel_isa, isa);
+        }
+        unlock_mutex(&cpu_mutex);
+    }
+    return (cpu_isa_t)isa;
+}
+
+bool set_kernel_isa(cpu_isa_t isa)
+{
+    if (!is_cpu_isa_supported(isa)) {
+        return false;
+    }
+    lock_mutex(&cpu_mutex);
+    store_atomic_int(&kernel_isa, isa);
+    unlock_mutex(&cpu_mutex);
+    return true;
+}
+
+void reset_kernel_isa()
+{
+    const cpu_isa_t selected = select_kernel_isa();
+    lock_mutex(&cpu_mutex);
+    store_atomic_int(&kernel_isa, selected);
+    unlock_mutex(&cpu_mutex);
+}
@@ -0,0 +1,72 @@
+#include "reim/decimator.h"
+
+#include "reim/mathematics.h"
+#include "reim/memory.h"
+#include <assert.h>
+
+// zero-crossings of the sinc on each side
+#define DECIMATOR_ZEROS 8
+
+decimator_t* create_decimator(size_t factor)
+{
+    assert(factor > 0);
+
+    decimator_t* decimator = REIM_ALLOC_SINGLE(decimator_t);
+    decimator->factor = factor;
+    decimator->half = (factor > 1) ? DECIMATOR_ZEROS * factor : 0;
+    decimator->length = 2 * decimator->half + 1;
+    decimator->filter = allocate_vector(decimator->length);
+
+    // Blackman windowed sinc, normalized to the unity DC gain
+    double sum = 0.0;
+    for (size_t i = 0; i < decimator->length; i++) {
+        const double t = (double)i - (double)decimator->half;
+        const double x = REIM_PI * t / factor;
+        const double sinc = (t == 0.0) ? 1.0 : sin(x) / x;
+        const double w = 2.0 * REIM_PI * (double)i / (decimator->length - 1);
+        const double window = (decimator->length > 1) ? 0.42 - 0.5 * cos(w) + 0.08 * cos(2 * w) : 1.0;
+        decimator->filter[i] = sinc * window;
+        sum += decimator->filter[i];
+    }
+    for (size_t i = 0; i < decimator->length; i++) {
+        decimator->filter[i] /= sum;
+    }
+
+    return decimator;
+}
+
+void destroy_decimator(decimator_t** decimator)
+{
+    free_vector((*decimator)->filter);
+    REIM_FREE(*decimator);
+    *decimator = NULL;
+}
+
+void execute_decimator(const decimator_t* decimator, const real_t* input, size_t length, size_t offset, real_t* output, size_t count)
+{
+    // the filter is symmetric: output[m] = sum_i filter[i] * input[position - half + i]
+    const size_t half = decimator->half;
+    const real_t* filter = decimator->filter;
+    for (size_t m = 0; m < count; m++) {
+        const size_t position = offset + m * decimator->factor;
+        const size_t first = (position < half) ? half - position : 0;
+        const size_t last = (position < length + half) ? MIN(length + half - position, decimator->length) : 0;
+        const size_t taps = (last > first) ? last - first : 0;
+        const real_t* h = filter + first;
+        const real_t* x = input + (position + first - half);
+
+        // four partial sums for the vectorization
+        double sum[4] = { 0.0, 0.0, 0.0, 0.0 };
+        size_t i = 0;
+        for (; i + 4 <= taps; i += 4) {
+            sum[0] += h[i + 0] * x[i + 0];
+            sum[1] += h[i + 1] * x[i + 1];
+            sum[2] += h[i + 2] * x[i + 2];
+            sum[3] += h[i + 3] * x[i + 3];
+        }
+        for (; i < taps; i++) {
+            sum[0] += h[i] * x[i];
+        }
+        output[m] = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+    }
+}
@@ -1,89 +1,315 @@
 #include "reim/fft.h"
 
+#include "reim/mathematics.h"
 #include "reim/memory.h"
+#include "reim/thread.h"
 #include <stdlib.h>
 
+typedef enum {
+    FFT_FORWARD,
+    FFT_BACKWARD,
+    RFFT_FORWARD,
+    RFFT_BACKWARD,
+    DCT_TYPE1,
+    DST_TYPE1,
+} fft_kind_t;
+
+// Plan shared by the objects (immutable after creation)
+typedef struct fft_plan {
+    fft_kind_t kind;
+    size_t fftsize;
+    size_t count;          // number of transforms (batch)
+    size_t refcount;       // number of objects using the plan
+    void* library;         // library dependent plan
+    struct fft_plan* next; // next plan in the cache
+} fft_plan_t;
+
+// Object returned by create_*() (owned by a caller)
+// The scratch is the work area of the library followed by the buffer for the split (real[], imag[]) interface.
+// The execute_*_with_scratch() functions take it from the caller instead, so they only read the object.
+typedef struct {
+    const fft_plan_t* plan;
+    complex_t* scratch; // scratch of the execute_*() functions
+} fft_object_t;
+
+// Library dependent part:
+//   create_library_plan() is called while the cache is locked,
+//   execute_library_plan() may be called from any threads at once.
+static bool is_library_fftsize(fft_kind_t kind, size_t fftsize);
+static void* create_library_plan(fft_kind_t kind, size_t fftsize, size_t count);
+static void destroy_library_plan(fft_kind_t kind, void* library);
+static size_t get_work_length(const fft_plan_t* plan);
+static complex_t* allocate_scratch(size_t length);
+static void free_scratch(complex_t* scratch);
+static void execute_library_plan(const fft_plan_t* plan, complex_t* data, complex_t* work);
+
+static mutex_t cache_mutex = MUTEX_INITIALIZER;
+static fft_plan_t* cache_head = NULL;
+
+static size_t get_buffer_length(fft_kind_t kind, size_t fftsize, size_t count)
+{
+    if (kind == FFT_FORWARD || kind == FFT_BACKWARD) {
+        return fftsize * count;
+    }
+    if (kind == DCT_TYPE1 || kind == DST_TYPE1) {
+        return (fftsize / 2 + 2) / 2; // real_t[fftsize / 2 + 1]
+    }
+    return (fftsize / 2 + 1) * count;
+}
+
+static bool is_symmetric_kind(fft_kind_t kind)
+{
+    return kind == DCT_TYPE1 || kind == DST_TYPE1;
+}
+
+// Real symmetric transforms through the real FFT (for the libraries without them)
+#if defined REIM_USE_MKL || !(defined REIM_USE_FFTW3 || defined REIM_USE_FFTSG)
+
+#include <math.h>
+
+typedef struct {
+    fft_plan_t rfft;     // real FFT of fftsize / 2 (or fftsize for the mirrored sequence)
+    bool ismirrored;     // the sequence of fftsize is transformed as it is (fftsize / 2 is odd or not supported)
+    real_t* table;       // sin(pi j / n) and cos(pi j / n) (n = fftsize / 2)
+    size_t work_length;  // buffer of the real FFT and its work area
+} symmetric_plan_t;
+
+static symmetric_plan_t* create_symmetric_plan(size_t fftsize)
+{
+    const size_t n = fftsize / 2;
+    symmetric_plan_t* symmetric = REIM_ALLOC_SINGLE(symmetric_plan_t);
+
+    // the half size if possible
+    symmetric->ismirrored = (n % 2 != 0 || !is_library_fftsize(RFFT_FORWARD, n));
+    symmetric->rfft.library = symmetric->ismirrored ? NULL : create_library_plan(RFFT_FORWARD, n, 1);
+    if (symmetric->rfft.library == NULL) {
+        symmetric->ismirrored = true;
+        symmetric->rfft.library = create_library_plan(RFFT_FORWARD, fftsize, 1);
+    }
+    if (symmetric->rfft.library == NULL) {
+        REIM_FREE(symmetric);
+        return NULL;
+    }
+    symmetric->rfft.kind = RFFT_FORWARD;
+    symmetric->rfft.fftsize = symmetric->ismirrored ? fftsize : n;
+    symmetric->rfft.count = 1;
+    symmetric->rfft.refcount = 0;
+    symmetric->rfft.next = NULL;
+    symmetric->work_length = symmetric->rfft.fftsize / 2 + 1 + get_work_length(&symmetric->rfft);
+
+    symmetric->table = allocate_vector(2 * n);
+    for (size_t j = 0; j < n; j++) {
+        symmetric->table[j] = sin(REIM_PI * j / n);
+        symmetric->table[n + j] = cos(REIM_PI * j / n);
+    }
+    return symmetric;
+}
+
+static void destroy_symmetric_plan(void* library)
+{
+    symmetric_plan_t* symmetric = (symmetric_plan_t*)library;
+    destroy_library_plan(RFFT_FORWARD, symmetric->rfft.library);
+    free_vector(symmetric->table);
+    REIM_FREE(symmetric);
+}
+
+static size_t get_symmetric_work_length(const fft_plan_t* plan)
+{
+    return ((const symmetric_plan_t*)plan->library)->work_length;
+}
+
+// DCT-I and DST-I with the mirrored sequence of fftsize
+static void execute_mirrored_plan(const symmetric_plan_t* symmetric, fft_kind_t kind, size_t n, real_t* x, complex_t* work)
+{
+    const double sign = (kind == DCT_TYPE1) ? 1.0 : -1.0;
+    real_t* y = (real_t*)work;
+    y[0] = (kind == DCT_TYPE1) ? x[0] : 0.0;
+    y[n] = (kind == DCT_TYPE1) ? x[n] : 0.0;
+    for (size_t j = 1; j < n; j++) {
+        y[j] = x[j];
+        y[2 * n - j] = sign * x[j];
+    }
+    execute_library_plan(&symmetric->rfft, work, work + n + 1);
+
+    // the DFT of the odd sequence is -i times the DST-I
+    if (kind == DCT_TYPE1) {
+        for (size_t k = 0; k <= n; k++) {
+            x[k] = work[k].re;
+        }
+    } else {
+        x[0] = 0.0;
+        x[n] = 0.0;
+        for (size_t k = 1; k < n; k++) {
+            x[k] = -work[k].im;
+        }
+    }
+}
+
+// DCT-I and DST-I with the real FFT of the half size (n = fftsize / 2 is even)
+// The sequence is folded to n samples, and the odd outputs are restored by the recurrence.
+static void execute_symmetric_plan(const fft_plan_t* plan, complex_t* data, complex_t* work)
+{
+    const symmetric_plan_t* symmetric = (const symmetric_plan_t*)plan->library;
+    const size_t n = plan->fftsize / 2;
+    real_t* x = (real_t*)data;
+    if (symmetric->ismirrored) {
+        execute_mirrored_plan(symmetric, plan->kind, n, x, work);
+        return;
+    }
+
+    const real_t* s = symmetric->table;
+    const real_t* c = symmetric->table + n;
+    real_t* y = (real_t*)work;
+    const complex_t* R = work;
+    if (plan->kind == DCT_TYPE1) {
+        // y[j] = (x[j] + x[n - j]) / 2 - sin(pi j / n) (x[j] - x[n - j])
+        double odd = x[0] - x[n]; // X[1]
+        y[0] = 0.5 * (x[0] + x[n]);
+        for (size_t j = 1; j < n; j++) {
+            y[j] = 0.5 * (x[j] + x[n - j]) - s[j] * (x[j] - x[n - j]);
+            odd += 2.0 * x[j] * c[j];
+        }
+        execute_library_plan(&symmetric->rfft, work, work + n / 2 + 1);
+
+        // X[2k] = 2 Re R[k], X[2k + 1] = X[2k - 1] - 2 Im R[k]
+        x[0] = 2.0 * R[0].re;
+        x[1] = odd;
+        for (size_t k = 1; k < n / 2; k++) {
+            x[2 * k] = 2.0 * R[k].re;
+            x[2 * k + 1] = x[2 * k - 1] - 2.0 * R[k].im;
+        }
+        x[n] = 2.0 * R[n / 2].re;
+    } else {
+        // y[j] = sin(pi j / n) (x[j] + x[n - j]) + (x[j] - x[n - j]) / 2
+        y[0] = 0.0;
+        for (size_t j = 1; j < n; j++) {
+            y[j] = s[j] * (x[j] + x[n - j]) + 0.5 * (x[j] - x[n - j]);
+        }
+        execute_library_plan(&symmetric->rfft, work, work + n / 2 + 1);
+
+        // X[2k] = -2 Im R[k], X[2k + 1] = X[2k - 1] + 2 Re R[k] (X[1] = Re R[0])
+        x[0] = 0.0;
+        x[1] = R[0].re;
+        for (size_t k = 1; k < n / 2; k++) {
+            x[2 * k] = -2.0 * R[k].im;
+            x[2 * k + 1] = x[2 * k - 1] + 2.0 * R[k].re;
+        }
+        x[n] = 0.0;
+    }
+}
+
+#endif
+
 // Library dependent implementations
 #ifdef REIM_USE_MKL // Intel MKL
 
 #include <mkl.h>
 
-typedef struct {
-    size_t fftsize;
-    DFTI_DESCRIPTOR_HANDLE descriptor;
-    double* buffer;
-} fft_mkl_t;
+#ifdef REIM_USE_FLOAT
+#define DFTI_REAL_PRECISION DFTI_SINGLE
+#else
+#define DFTI_REAL_PRECISION DFTI_DOUBLE
+#endif
 
-fft_t* create_fft(size_t fftsize)
+static bool is_library_fftsize(fft_kind_t kind, size_t fftsize)
+{
+    if (is_symmetric_kind(kind)) {
+        return fftsize >= 4 && fftsize % 2 == 0;
+    }
+    return fftsize > 0;
+}
+
+// The trigonometric transforms of MKL keep the parameters changed by the calls,
+// so the real symmetric transforms use the real DFT instead to share the plans.
+static void* create_library_plan(fft_kind_t kind, size_t fftsize, size_t count)
 {
-    fft_mkl_t* mkl = REIM_ALLOC_SINGLE(fft_mkl_t);
-    mkl->fftsize = fftsize;
+    const bool isreal = (kind == RFFT_FORWARD || kind == RFFT_BACKWARD);
+    DFTI_DESCRIPTOR_HANDLE descriptor;
+    if (is_symmetric_kind(kind)) {
+        return create_symmetric_plan(fftsize);
+    }
 
     MKL_LONG err;
-    if ((err = DftiCreateDescriptor(&mkl->descriptor, DFTI_DOUBLE, DFTI_COMPLEX, 1, mkl->fftsize))) {
+    if ((err = DftiCreateDescriptor(&descriptor, DFTI_REAL_PRECISION, isreal ? DFTI_REAL : DFTI_COMPLEX, 1, fftsize))) {
         // puts(DftiErrorMessage(err));
-        REIM_FREE(mkl);
         return NULL;
     }
 
-    if ((err = DftiCommitDescriptor(mkl->descriptor))) {
+    // real domain: CCE format (fftsize / 2 + 1 interleaved complex values)
+    if (isreal) {
+        DftiSetValue(descriptor, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
+    }
+
+    // batch of the inverse real transforms (complex rows in, real rows out)
+    if (count > 1) {
+        const MKL_LONG numbins = fftsize / 2 + 1;
+        DftiSetValue(descriptor, DFTI_NUMBER_OF_TRANSFORMS, (MKL_LONG)count);
+        DftiSetValue(descriptor, DFTI_INPUT_DISTANCE, numbins);
+        DftiSetValue(descriptor, DFTI_OUTPUT_DISTANCE, numbins * 2);
+    }
+
+    if ((err = DftiCommitDescriptor(descriptor))) {
         // puts(DftiErrorMessage(err));
-        REIM_FREE(mkl);
+        DftiFreeDescriptor(&descriptor);
         return NULL;
     }
 
-    mkl->buffer = allocate_vector(mkl->fftsize * 2);
-    return (fft_t*)mkl;
+    return (void*)descriptor;
 }
 
-ifft_t* create_ifft(size_t fftsize)
+static void destroy_library_plan(fft_kind_t kind, void* library)
 {
-    return (ifft_t*)create_fft(fftsize);
+    if (is_symmetric_kind(kind)) {
+        destroy_symmetric_plan(library);
+        return;
+    }
+    DFTI_DESCRIPTOR_HANDLE descriptor = (DFTI_DESCRIPTOR_HANDLE)library;
+    DftiFreeDescriptor(&descriptor);
 }
 
-void destroy_fft(fft_t** fft)
+static size_t get_work_length(const fft_plan_t* plan)
 {
-    fft_mkl_t* mkl = (fft_mkl_t*)*fft;
-    DftiFreeDescriptor(&mkl->descriptor);
-    free_vector(mkl->buffer);
-    REIM_FREE(mkl);
-    *fft = NULL;
+    if (is_symmetric_kind(plan->kind)) {
+        return get_symmetric_work_length(plan);
+    }
+    return 0;
 }
 
-void destroy_ifft(ifft_t** ifft)
+static complex_t* allocate_scratch(size_t length)
 {
-    destroy_fft((fft_t**)ifft);
+    return REIM_ALLOC(length, complex_t);
 }
 
-void execute_fft(fft_t* fft, double* real, double* imag)
+static void free_scratch(complex_t* scratch)
 {
-    fft_mkl_t* mkl = (fft_mkl_t*)fft;
+    REIM_FREE(scratch);
+}
 
-    for (size_t i = 0; i < mkl->fftsize; i++) {
-        mkl->buffer[i * 2 + 0] = real[i];
-        mkl->buffer[i * 2 + 1] = imag[i];
+static void execute_library_plan(const fft_plan_t* plan, complex_t* data, complex_t* work)
+{
+    DFTI_DESCRIPTOR_HANDLE descriptor = (DFTI_DESCRIPTOR_HANDLE)plan->library;
+    if (is_symmetric_kind(plan->kind)) {
+        execute_symmetric_plan(plan, data, work);
+        return;
     }
-    DftiComputeForward(mkl->descriptor, mkl->buffer);
-    for (size_t i = 0; i < mkl->fftsize; i++) {
-        real[i] = mkl->buffer[i * 2 + 0];
-        imag[i] = mkl->buffer[i * 2 + 1];
+
+    if (plan->kind == FFT_FORWARD || plan->kind == RFFT_FORWARD) {
+        DftiComputeForward(descriptor, data);
+    } else {
+        DftiComputeBackward(descriptor, data);
     }
 }
 
-void execute_ifft(ifft_t* ifft, double* real, double* imag)
+bool import_fft_wisdom(const char* filename)
 {
-    fft_mkl_t* mkl = (fft_mkl_t*)ifft;
-    double scale = mkl->fftsize;
+    (void)filename;
+    return false;
+}
 
-    for (size_t i = 0; i < mkl->fftsize; i++) {
-        mkl->buffer[i * 2 + 0] = real[i];
-        mkl->buffer[i * 2 + 1] = imag[i];
-    }
-    DftiComputeBackward(mkl->descriptor, mkl->buffer);
-    for (size_t i = 0; i < mkl->fftsize; i++) {
-        real[i] = mkl->buffer[i * 2 + 0] / scale;
-        imag[i] = mkl->buffer[i * 2 + 1] / scale;
-    }
+bool export_fft_wisdom(const char* filename)
+{
+    (void)filename;
+    return false;
 }
 
 const char* get_fft_library_name()
@@ -95,159 +321,834 @@ const char* get_fft_library_name()
 
 #include <fftw3.h>
 
+// fftwf_* for the single precision build (link libfftw3f)
+#ifdef REIM_USE_FLOAT
+#define FFTW(name) fftwf_##name
+#else
+#define FFTW(name) fftw_##name
+#endif
+
 typedef struct {
-    size_t fftsize;
-    fftw_complex* buffer;
-    fftw_plan plan;
+    FFTW(plan) plan;
+    int alignment; // alignment of the planned buffer
 } fftw3_t;
 
-fft_t* create_fft(size_t fftsize)
+static bool is_library_fftsize(fft_kind_t kind, size_t fftsize)
 {
-    fftw3_t* fftw = REIM_ALLOC_SINGLE(fftw3_t);
-    fftw->fftsize = fftsize;
-    fftw->buffer = (fftw_complex*)fftw_malloc(fftw->fftsize * sizeof(fftw_complex));
-    fftw->plan = fftw_plan_dft_1d(fftsize, fftw->buffer, fftw->buffer, FFTW_FORWARD, FFTW_MEASURE);
-    return (fft_t*)fftw;
+    if (is_symmetric_kind(kind)) {
+        return fftsize >= 4 && fftsize % 2 == 0;
+    }
+    return fftsize > 0;
 }
 
-ifft_t* create_ifft(size_t fftsize)
+static void* create_library_plan(fft_kind_t kind, size_t fftsize, size_t count)
 {
+    const int n = (int)fftsize;
+    const int numbins = n / 2 + 1;
+    FFTW(complex)* buffer = (FFTW(complex)*)FFTW(malloc)(get_buffer_length(kind, fftsize, count) * sizeof(FFTW(complex)));
+
+    // DST-I (RODFT00) is planned on the samples except for the both ends
     fftw3_t* fftw = REIM_ALLOC_SINGLE(fftw3_t);
-    fftw->fftsize = fftsize;
-    fftw->buffer = (fftw_complex*)fftw_malloc(fftw->fftsize * sizeof(fftw_complex));
-    fftw->plan = fftw_plan_dft_1d(fftsize, fftw->buffer, fftw->buffer, FFTW_BACKWARD, FFTW_MEASURE);
-    return (ifft_t*)fftw;
+    fftw->alignment = FFTW(alignment_of)((real_t*)buffer + ((kind == DST_TYPE1) ? 1 : 0));
+    switch (kind) {
+    case FFT_FORWARD:
+        fftw->plan = FFTW(plan_dft_1d)(n, buffer, buffer, FFTW_FORWARD, FFTW_MEASURE);
+        break;
+    case FFT_BACKWARD:
+        fftw->plan = FFTW(plan_dft_1d)(n, buffer, buffer, FFTW_BACKWARD, FFTW_MEASURE);
+        break;
+    case RFFT_FORWARD:
+        fftw->plan = FFTW(plan_dft_r2c_1d)(n, (real_t*)buffer, buffer, FFTW_MEASURE);
+        break;
+    case RFFT_BACKWARD:
+        fftw->plan = FFTW(plan_many_dft_c2r)(1, &n, (int)count,
+            buffer, NULL, 1, numbins,
+            (real_t*)buffer, NULL, 1, numbins * 2, FFTW_MEASURE);
+        break;
+    case DCT_TYPE1:
+        fftw->plan = FFTW(plan_r2r_1d)(numbins, (real_t*)buffer, (real_t*)buffer, FFTW_REDFT00, FFTW_MEASURE);
+        break;
+    case DST_TYPE1:
+        fftw->plan = FFTW(plan_r2r_1d)(numbins - 2, (real_t*)buffer + 1, (real_t*)buffer + 1, FFTW_RODFT00, FFTW_MEASURE);
+        break;
+    }
+
+    // the plans are executed with the new-array interface, so the buffer is not kept
+    FFTW(free)(buffer);
+    if (fftw->plan == NULL) {
+        REIM_FREE(fftw);
+        return NULL;
+    }
+    return (void*)fftw;
 }
 
-void destroy_fft(fft_t** fft)
+static void destroy_library_plan(fft_kind_t kind, void* library)
 {
-    fftw3_t* fftw = (fftw3_t*)*fft;
-    fftw_destroy_plan(fftw->plan);
-    fftw_free(fftw->buffer);
+    fftw3_t* fftw = (fftw3_t*)library;
+    (void)kind;
+    FFTW(destroy_plan)(fftw->plan);
     REIM_FREE(fftw);
-    *fft = NULL;
 }
 
-void destroy_ifft(ifft_t** ifft)
+// buffer for the unaligned data
+static size_t get_work_length(const fft_plan_t* plan)
+{
+    return get_buffer_length(plan->kind, plan->fftsize, plan->count);
+}
+
+static complex_t* allocate_scratch(size_t length)
+{
+    return (complex_t*)FFTW(malloc)(length * sizeof(FFTW(complex)));
+}
+
+static void free_scratch(complex_t* scratch)
 {
-    destroy_fft((fft_t**)ifft);
+    FFTW(free)(scratch);
 }
 
-void execute_fft(fft_t* fft, double* real, double* imag)
+// DCT-I and DST-I on real_t[fftsize / 2 + 1] (DST-I: except for the both ends)
+static void execute_fftw_r2r(const fft_plan_t* plan, real_t* data, real_t* work)
 {
-    fftw3_t* fftw = (fftw3_t*)fft;
+    const fftw3_t* fftw = (const fftw3_t*)plan->library;
+    const size_t offset = (plan->kind == DST_TYPE1) ? 1 : 0;
+    const size_t length = plan->fftsize / 2 + 1 - 2 * offset;
+
+    // the work area has the same alignment as the planned buffer
+    real_t* input = data + offset;
+    const bool isaligned = (FFTW(alignment_of)(input) == fftw->alignment);
+    real_t* buffer = isaligned ? input : work + offset;
+    if (!isaligned) {
+        for (size_t i = 0; i < length; i++) {
+            buffer[i] = input[i];
+        }
+    }
+
+    FFTW(execute_r2r)(fftw->plan, buffer, buffer);
 
-    for (size_t i = 0; i < fftw->fftsize; i++) {
-        fftw->buffer[i][0] = real[i];
-        fftw->buffer[i][1] = imag[i];
+    if (!isaligned) {
+        for (size_t i = 0; i < length; i++) {
+            input[i] = buffer[i];
+        }
     }
-    fftw_execute(fftw->plan);
-    for (size_t i = 0; i < fftw->fftsize; i++) {
-        real[i] = fftw->buffer[i][0];
-        imag[i] = fftw->buffer[i][1];
+    if (offset > 0) {
+        data[0] = 0.0;
+        data[length + 1] = 0.0;
     }
 }
 
-void execute_ifft(ifft_t* ifft, double* real, double* imag)
+static void execute_library_plan(const fft_plan_t* plan, complex_t* data, complex_t* work)
 {
-    fftw3_t* fftw = (fftw3_t*)ifft;
-    double scale = fftw->fftsize;
+    const fftw3_t* fftw = (const fftw3_t*)plan->library;
+    const size_t length = get_buffer_length(plan->kind, plan->fftsize, plan->count);
+    if (is_symmetric_kind(plan->kind)) {
+        execute_fftw_r2r(plan, (real_t*)data, (real_t*)work);
+        return;
+    }
 
-    for (size_t i = 0; i < fftw->fftsize; i++) {
-        fftw->buffer[i][0] = real[i];
-        fftw->buffer[i][1] = imag[i];
+    // The plans can be applied to another buffer only when the SIMD alignment matches.
+    // Otherwise the data goes through the work area of the object.
+    const bool isaligned = (FFTW(alignment_of)((real_t*)data) == fftw->alignment);
+    FFTW(complex)* buffer = (FFTW(complex)*)(isaligned ? data : work);
+    if (!isaligned) {
+        for (size_t i = 0; i < length; i++) {
+            work[i] = data[i];
+        }
     }
-    fftw_execute(fftw->plan);
-    for (size_t i = 0; i < fftw->fftsize; i++) {
-        real[i] = fftw->buffer[i][0] / scale;
-        imag[i] = fftw->buffer[i][1] / scale;
+
+    switch (plan->kind) {
+    case FFT_FORWARD:
+    case FFT_BACKWARD:
+        FFTW(execute_dft)(fftw->plan, buffer, buffer);
+        break;
+    case RFFT_FORWARD:
+        FFTW(execute_dft_r2c)(fftw->plan, (real_t*)buffer, buffer);
+        break;
+    case RFFT_BACKWARD:
+        FFTW(execute_dft_c2r)(fftw->plan, buffer, (real_t*)buffer);
+        break;
+    default:
+        break;
+    }
+
+    if (!isaligned) {
+        for (size_t i = 0; i < length; i++) {
+            data[i] = work[i];
+        }
     }
 }
 
+// The planner of FFTW (including the wisdom) is not thread-safe, so it shares the cache lock
+bool import_fft_wisdom(const char* filename)
+{
+    lock_mutex(&cache_mutex);
+    const bool success = (FFTW(import_wisdom_from_filename)(filename) != 0);
+    unlock_mutex(&cache_mutex);
+    return success;
+}
+
+bool export_fft_wisdom(const char* filename)
+{
+    lock_mutex(&cache_mutex);
+    const bool success = (FFTW(export_wisdom_to_filename)(filename) != 0);
+    unlock_mutex(&cache_mutex);
+    return success;
+}
+
 const char* get_fft_library_name()
 {
     return "FFTW3";
 }
 
-#else // fftsg (internal implementation)
+#elif defined REIM_USE_FFTSG // fftsg (Ooura's FFT package)
 
 #include <math.h>
 
 // fftsg.c
-void cdft(int n, int isgn, double* a, int* ip, double* w);
+void cdft(int n, int isgn, real_t* a, int* ip, real_t* w);
+void rdft(int n, int isgn, real_t* a, int* ip, real_t* w);
+void makewt(int nw, int* ip, real_t* w);
+void makect(int nc, int* ip, real_t* c);
+void dfct(int n, real_t* a, real_t* t, int* ip, real_t* w);
+void dfst(int n, real_t* a, real_t* t, int* ip, real_t* w);
 
 typedef struct {
-    size_t fftsize;
-    double* buffer;
     int* work;
-    double* table;
+    real_t* table;
 } fftsg_t;
 
-fft_t* create_fft(size_t fftsize)
+// powers of two only (dfct() and dfst() keep the tables for fftsize of 16 or more)
+static bool is_library_fftsize(fft_kind_t kind, size_t fftsize)
 {
-    fftsg_t* ooura = REIM_ALLOC_SINGLE(fftsg_t);
-    ooura->fftsize = fftsize;
-    ooura->buffer = allocate_vector(ooura->fftsize * 2);
-    ooura->work = REIM_ALLOC(2 + ceil(sqrt(ooura->fftsize)), int);
-    ooura->table = allocate_vector(ooura->fftsize / 2);
-    ooura->work[0] = 0.0;
-    return (fft_t*)ooura;
+    const bool isreal = (kind == RFFT_FORWARD || kind == RFFT_BACKWARD);
+    return ISPOW2(fftsize) && !(isreal && fftsize < 2) && !(is_symmetric_kind(kind) && fftsize < 16);
 }
 
-ifft_t* create_ifft(size_t fftsize)
+static void* create_library_plan(fft_kind_t kind, size_t fftsize, size_t count)
 {
-    return (ifft_t*)create_fft(fftsize);
+    const int n = (int)fftsize;
+    (void)count;
+
+    // rdft() uses the same work area and table sizes as cdft()
+    fftsg_t* ooura = REIM_ALLOC_SINGLE(fftsg_t);
+    ooura->work = REIM_ALLOC(2 + ceil(sqrt(fftsize)), int);
+    ooura->table = allocate_vector(fftsize / 2);
+
+    // Build the tables here instead of the first call of cdft()/rdft(),
+    // so the transforms only read them
+    if (kind == FFT_FORWARD || kind == FFT_BACKWARD) {
+        makewt(n >> 1, ooura->work, ooura->table);
+    } else if (is_symmetric_kind(kind)) {
+        // dfct() and dfst() of n / 2
+        makewt(n >> 4, ooura->work, ooura->table);
+        makect(n >> 2, ooura->work, ooura->table + (n >> 4));
+    } else {
+        makewt(n >> 2, ooura->work, ooura->table);
+        makect(n >> 2, ooura->work, ooura->table + (n >> 2));
+    }
+    return (void*)ooura;
 }
 
-void destroy_fft(fft_t** fft)
+static void destroy_library_plan(fft_kind_t kind, void* library)
 {
-    fftsg_t* ooura = (fftsg_t*)*fft;
-    free_vector(ooura->buffer);
+    fftsg_t* ooura = (fftsg_t*)library;
+    (void)kind;
     REIM_FREE(ooura->work);
     free_vector(ooura->table);
     REIM_FREE(ooura);
-    *fft = NULL;
 }
 
-void destroy_ifft(ifft_t** ifft)
+// work area of dfct() and dfst() (fftsize / 4 + 1 real values)
+static size_t get_work_length(const fft_plan_t* plan)
+{
+    return is_symmetric_kind(plan->kind) ? plan->fftsize / 8 + 1 : 0;
+}
+
+static complex_t* allocate_scratch(size_t length)
 {
-    destroy_fft((fft_t**)ifft);
+    return REIM_ALLOC(length, complex_t);
 }
 
-void execute_fft(fft_t* fft, double* real, double* imag)
+static void free_scratch(complex_t* scratch)
 {
-    fftsg_t* ooura = (fftsg_t*)fft;
+    REIM_FREE(scratch);
+}
 
-    for (size_t i = 0; i < ooura->fftsize; i++) {
-        ooura->buffer[i * 2 + 0] = real[i];
-        ooura->buffer[i * 2 + 1] = imag[i];
+// dfct() and dfst() sum the inner samples with the unit weights
+static void execute_dfct(const fftsg_t* ooura, fft_kind_t kind, size_t fftsize, real_t* data, real_t* work)
+{
+    const size_t n = fftsize / 2;
+    for (size_t j = 1; j < n; j++) {
+        data[j] *= 2.0;
+    }
+    if (kind == DCT_TYPE1) {
+        dfct(n, data, work, ooura->work, ooura->table);
+    } else {
+        dfst(n, data, work, ooura->work, ooura->table);
+        data[0] = 0.0;
+        data[n] = 0.0;
     }
-    cdft(ooura->fftsize * 2, -1, ooura->buffer, ooura->work, ooura->table);
-    for (size_t i = 0; i < ooura->fftsize; i++) {
-        real[i] = ooura->buffer[i * 2 + 0];
-        imag[i] = ooura->buffer[i * 2 + 1];
+}
+
+static void execute_rdft_forward(const fftsg_t* ooura, size_t fftsize, complex_t* data)
+{
+    const size_t half = fftsize / 2;
+
+    rdft(fftsize, +1, (real_t*)data, ooura->work, ooura->table);
+
+    // rdft() packs the Nyquist bin into a[1] and uses exp(+j) for the imaginary part
+    data[half].re = data[0].im;
+    data[half].im = 0.0;
+    data[0].im = 0.0;
+    for (size_t k = 1; k < half; k++) {
+        data[k].im = -data[k].im;
     }
 }
 
-void execute_ifft(ifft_t* ifft, double* real, double* imag)
+static void execute_rdft_backward(const fftsg_t* ooura, size_t fftsize, complex_t* data)
 {
-    fftsg_t* ooura = (fftsg_t*)ifft;
-    double scale = ooura->fftsize;
+    const size_t half = fftsize / 2;
 
-    for (size_t i = 0; i < ooura->fftsize; i++) {
-        ooura->buffer[i * 2 + 0] = real[i];
-        ooura->buffer[i * 2 + 1] = imag[i];
+    // rdft() returns the half of the unnormalized inverse
+    data[0].re = 2.0 * data[0].re;
+    data[0].im = 2.0 * data[half].re;
+    for (size_t k = 1; k < half; k++) {
+        data[k].re = 2.0 * data[k].re;
+        data[k].im = -2.0 * data[k].im;
     }
-    cdft(ooura->fftsize * 2, +1, ooura->buffer, ooura->work, ooura->table);
-    for (size_t i = 0; i < ooura->fftsize; i++) {
-        real[i] = ooura->buffer[i * 2 + 0] / scale;
-        imag[i] = ooura->buffer[i * 2 + 1] / scale;
+
+    rdft(fftsize, -1, (real_t*)data, ooura->work, ooura->table);
+}
+
+static void execute_library_plan(const fft_plan_t* plan, complex_t* data, complex_t* work)
+{
+    const fftsg_t* ooura = (const fftsg_t*)plan->library;
+    const size_t fftsize = plan->fftsize;
+    const size_t numbins = fftsize / 2 + 1;
+
+    switch (plan->kind) {
+    case FFT_FORWARD:
+        cdft(fftsize * 2, -1, (real_t*)data, ooura->work, ooura->table);
+        break;
+    case FFT_BACKWARD:
+        cdft(fftsize * 2, +1, (real_t*)data, ooura->work, ooura->table);
+        break;
+    case RFFT_FORWARD:
+        execute_rdft_forward(ooura, fftsize, data);
+        break;
+    case RFFT_BACKWARD:
+        // one row after another: the row and the shared table stay in cache
+        for (size_t i = 0; i < plan->count; i++) {
+            execute_rdft_backward(ooura, fftsize, data + i * numbins);
+        }
+        break;
+    case DCT_TYPE1:
+    case DST_TYPE1:
+        execute_dfct(ooura, plan->kind, fftsize, (real_t*)data, (real_t*)work);
+        break;
     }
 }
 
+bool import_fft_wisdom(const char* filename)
+{
+    (void)filename;
+    return false;
+}
+
+bool export_fft_wisdom(const char* filename)
+{
+    (void)filename;
+    return false;
+}
+
 const char* get_fft_library_name()
 {
     return "fftsg";
 }
 
+#else // native (internal implementation)
+
+// fft_native.c
+bool is_native_fft_size(size_t fftsize, bool isreal);
+void* create_native_fft(size_t fftsize, bool isreal, bool inverse);
+void destroy_native_fft(void* native);
+size_t get_native_fft_work_length(const void* native);
+const char* get_native_fft_kernel_name();
+void execute_native_fft(const void* native, complex_t* data, complex_t* work);
+
+// 2^a 3^b 5^c
+static bool is_library_fftsize(fft_kind_t kind, size_t fftsize)
+{
+    if (is_symmetric_kind(kind)) {
+        return fftsize >= 4 && fftsize % 2 == 0 && is_native_fft_size(fftsize, true);
+    }
+    return is_native_fft_size(fftsize, kind == RFFT_FORWARD || kind == RFFT_BACKWARD);
+}
+
+static void* create_library_plan(fft_kind_t kind, size_t fftsize, size_t count)
+{
+    const bool isreal = (kind == RFFT_FORWARD || kind == RFFT_BACKWARD);
+    const bool inverse = (kind == FFT_BACKWARD || kind == RFFT_BACKWARD);
+    (void)count;
+    if (is_symmetric_kind(kind)) {
+        return create_symmetric_plan(fftsize);
+    }
+    return create_native_fft(fftsize, isreal, inverse);
+}
+
+static void destroy_library_plan(fft_kind_t kind, void* library)
+{
+    if (is_symmetric_kind(kind)) {
+        destroy_symmetric_plan(library);
+        return;
+    }
+    destroy_native_fft(library);
+}
+
+static size_t get_work_length(const fft_plan_t* plan)
+{
+    if (is_symmetric_kind(plan->kind)) {
+        return get_symmetric_work_length(plan);
+    }
+    return get_native_fft_work_length(plan->library);
+}
+
+static complex_t* allocate_scratch(size_t length)
+{
+    return REIM_ALLOC(length, complex_t);
+}
+
+static void free_scratch(complex_t* scratch)
+{
+    REIM_FREE(scratch);
+}
+
+static void execute_library_plan(const fft_plan_t* plan, complex_t* data, complex_t* work)
+{
+    const size_t numbins = plan->fftsize / 2 + 1;
+    if (is_symmetric_kind(plan->kind)) {
+        execute_symmetric_plan(plan, data, work);
+        return;
+    }
+    if (plan->count == 1) {
+        execute_native_fft(plan->library, data, work);
+        return;
+    }
+
+    // batch: one row after another
+    for (size_t i = 0; i < plan->count; i++) {
+        execute_native_fft(plan->library, data + i * numbins, work);
+    }
+}
+
+bool import_fft_wisdom(const char* filename)
+{
+    (void)filename;
+    return false;
+}
+
+bool export_fft_wisdom(const char* filename)
+{
+    (void)filename;
+    return false;
+}
+
+const char* get_fft_library_name()
+{
+    return get_native_fft_kernel_name();
+}
+
 #endif
+
+// Plan cache (library independent)
+// The plans stay in the cache after the last object is destroyed,
+// so the next object of the same type is created without planning.
+
+static fft_plan_t* acquire_plan(fft_kind_t kind, size_t fftsize, size_t count)
+{
+    if (!is_library_fftsize(kind, fftsize)) {
+        return NULL;
+    }
+
+    lock_mutex(&cache_mutex);
+
+    fft_plan_t* plan = cache_head;
+    while (plan != NULL && !(plan->kind == kind && plan->fftsize == fftsize && plan->count == count)) {
+        plan = plan->next;
+    }
+
+    if (plan == NULL) {
+        void* library = create_library_plan(kind, fftsize, count);
+        if (library != NULL) {
+            plan = REIM_ALLOC_SINGLE(fft_plan_t);
+            plan->kind = kind;
+            plan->fftsize = fftsize;
+            plan->count = count;
+            plan->refcount = 0;
+            plan->library = library;
+            plan->next = cache_head;
+            cache_head = plan;
+        }
+    }
+
+    if (plan != NULL) {
+        plan->refcount++;
+    }
+
+    unlock_mutex(&cache_mutex);
+    return plan;
+}
+
+static void release_plan(fft_plan_t* plan)
+{
+    lock_mutex(&cache_mutex);
+    plan->refcount--;
+    unlock_mutex(&cache_mutex);
+}
+
+// The buffer starts at a multiple of 4 complex values, so that it has the alignment of the scratch (FFTW).
+static size_t get_buffer_offset(const fft_plan_t* plan)
+{
+    return (get_work_length(plan) + 3) / 4 * 4;
+}
+
+static size_t get_scratch_length(const fft_plan_t* plan)
+{
+    return get_buffer_offset(plan) + get_buffer_length(plan->kind, plan->fftsize, plan->count);
+}
+
+static fft_object_t* create_object(fft_kind_t kind, size_t fftsize, size_t count)
+{
+    fft_plan_t* plan = acquire_plan(kind, fftsize, count);
+    if (plan == NULL) {
+        return NULL;
+    }
+
+    fft_object_t* object = REIM_ALLOC_SINGLE(fft_object_t);
+    object->plan = plan;
+    object->scratch = allocate_scratch(get_scratch_length(plan));
+    return object;
+}
+
+static void destroy_object(void** fft)
+{
+    fft_object_t* object = (fft_object_t*)*fft;
+    release_plan((fft_plan_t*)object->plan);
+    free_scratch(object->scratch);
+    REIM_FREE(object);
+    *fft = NULL;
+}
+
+static void execute_object(const void* fft, complex_t* data, complex_t* scratch)
+{
+    const fft_object_t* object = (const fft_object_t*)fft;
+    execute_library_plan(object->plan, data, scratch);
+}
+
+// buffer for the split format interface in the scratch
+static complex_t* get_buffer(const fft_object_t* object, complex_t* scratch)
+{
+    return scratch + get_buffer_offset(object->plan);
+}
+
+size_t get_fft_scratch_length(const void* object)
+{
+    return get_scratch_length(((const fft_object_t*)object)->plan);
+}
+
+complex_t* allocate_fft_scratch(size_t length)
+{
+    return allocate_scratch(length);
+}
+
+void free_fft_scratch(complex_t* scratch)
+{
+    free_scratch(scratch);
+}
+
+void warmup_fft(size_t fftsize)
+{
+    const fft_kind_t kinds[] = { FFT_FORWARD, FFT_BACKWARD, RFFT_FORWARD, RFFT_BACKWARD, DCT_TYPE1, DST_TYPE1 };
+    for (size_t i = 0; i < sizeof(kinds) / sizeof(kinds[0]); i++) {
+        fft_plan_t* plan = acquire_plan(kinds[i], fftsize, 1);
+        if (plan != NULL) {
+            release_plan(plan);
+        }
+    }
+}
+
+bool is_supported_fftsize(size_t fftsize)
+{
+    const fft_kind_t kinds[] = { FFT_FORWARD, FFT_BACKWARD, RFFT_FORWARD, RFFT_BACKWARD };
+    if (fftsize % 2 != 0) {
+        return false;
+    }
+    for (size_t i = 0; i < sizeof(kinds) / sizeof(kinds[0]); i++) {
+        if (!is_library_fftsize(kinds[i], fftsize)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t get_next_fftsize(size_t length)
+{
+    size_t fftsize = MAX(length, 2);
+    while (!is_supported_fftsize(fftsize)) {
+        fftsize++;
+    }
+    return fftsize;
+}
+
+void clear_fft_cache()
+{
+    lock_mutex(&cache_mutex);
+
+    // the plans in use are kept
+    fft_plan_t** link = &cache_head;
+    while (*link != NULL) {
+        fft_plan_t* plan = *link;
+        if (plan->refcount == 0) {
+            *link = plan->next;
+            destroy_library_plan(plan->kind, plan->library);
+            REIM_FREE(plan);
+        } else {
+            link = &plan->next;
+        }
+    }
+
+    unlock_mutex(&cache_mutex);
+}
+
+fft_t* create_fft(size_t fftsize)
+{
+    return (fft_t*)create_object(FFT_FORWARD, fftsize, 1);
+}
+
+ifft_t* create_ifft(size_t fftsize)
+{
+    return (ifft_t*)create_object(FFT_BACKWARD, fftsize, 1);
+}
+
+rfft_t* create_rfft(size_t fftsize)
+{
+    return (rfft_t*)create_object(RFFT_FORWARD, fftsize, 1);
+}
+
+irfft_t* create_irfft(size_t fftsize)
+{
+    return (irfft_t*)create_object(RFFT_BACKWARD, fftsize, 1);
+}
+
+irfft_batch_t* create_irfft_batch(size_t fftsize, size_t count)
+{
+    return (irfft_batch_t*)create_object(RFFT_BACKWARD, fftsize, count);
+}
+
+dct_t* create_dct(size_t fftsize)
+{
+    return (dct_t*)create_object(DCT_TYPE1, fftsize, 1);
+}
+
+dst_t* create_dst(size_t fftsize)
+{
+    return (dst_t*)create_object(DST_TYPE1, fftsize, 1);
+}
+
+void destroy_fft(fft_t** fft)
+{
+    destroy_object(fft);
+}
+
+void destroy_ifft(ifft_t** ifft)
+{
+    destroy_object(ifft);
+}
+
+void destroy_rfft(rfft_t** rfft)
+{
+    destroy_object(rfft);
+}
+
+void destroy_irfft(irfft_t** irfft)
+{
+    destroy_object(irfft);
+}
+
+void destroy_irfft_batch(irfft_batch_t** batch)
+{
+    destroy_object(batch);
+}
+
+void destroy_dct(dct_t** dct)
+{
+    destroy_object(dct);
+}
+
+void destroy_dst(dst_t** dst)
+{
+    destroy_object(dst);
+}
+
+void execute_fft_inplace(fft_t* fft, complex_t* data)
+{
+    execute_object(fft, data, ((fft_object_t*)fft)->scratch);
+}
+
+void execute_fft_inplace_with_scratch(const fft_t* fft, complex_t* data, complex_t* scratch)
+{
+    execute_object(fft, data, scratch);
+}
+
+void execute_ifft_inplace(ifft_t* ifft, complex_t* data)
+{
+    execute_object(ifft, data, ((fft_object_t*)ifft)->scratch);
+}
+
+void execute_ifft_inplace_with_scratch(const ifft_t* ifft, complex_t* data, complex_t* scratch)
+{
+    execute_object(ifft, data, scratch);
+}
+
+void execute_rfft_inplace(rfft_t* rfft, complex_t* data)
+{
+    execute_object(rfft, data, ((fft_object_t*)rfft)->scratch);
+}
+
+void execute_rfft_inplace_with_scratch(const rfft_t* rfft, complex_t* data, complex_t* scratch)
+{
+    execute_object(rfft, data, scratch);
+}
+
+void execute_irfft_inplace(irfft_t* irfft, complex_t* data)
+{
+    execute_object(irfft, data, ((fft_object_t*)irfft)->scratch);
+}
+
+void execute_irfft_inplace_with_scratch(const irfft_t* irfft, complex_t* data, complex_t* scratch)
+{
+    execute_object(irfft, data, scratch);
+}
+
+void execute_irfft_batch(irfft_batch_t* batch, complex_t* data)
+{
+    execute_object(batch, data, ((fft_object_t*)batch)->scratch);
+}
+
+void execute_irfft_batch_with_scratch(const irfft_batch_t* batch, complex_t* data, complex_t* scratch)
+{
+    execute_object(batch, data, scratch);
+}
+
+void execute_dct_inplace(dct_t* dct, real_t* data)
+{
+    execute_object(dct, (complex_t*)data, ((fft_object_t*)dct)->scratch);
+}
+
+void execute_dct_inplace_with_scratch(const dct_t* dct, real_t* data, complex_t* scratch)
+{
+    execute_object(dct, (complex_t*)data, scratch);
+}
+
+void execute_dst_inplace(dst_t* dst, real_t* data)
+{
+    execute_object(dst, (complex_t*)data, ((fft_object_t*)dst)->scratch);
+}
+
+void execute_dst_inplace_with_scratch(const dst_t* dst, real_t* data, complex_t* scratch)
+{
+    execute_object(dst, (complex_t*)data, scratch);
+}
+
+// Split format interface (library independent)
+
+void execute_fft(fft_t* fft, real_t* real, real_t* imag)
+{
+    execute_fft_with_scratch(fft, real, imag, ((fft_object_t*)fft)->scratch);
+}
+
+void execute_fft_with_scratch(const fft_t* fft, real_t* real, real_t* imag, complex_t* scratch)
+{
+    const fft_object_t* object = (const fft_object_t*)fft;
+    complex_t* buffer = get_buffer(object, scratch);
+    const size_t fftsize = object->plan->fftsize;
+
+    for (size_t i = 0; i < fftsize; i++) {
+        buffer[i].re = real[i];
+        buffer[i].im = imag[i];
+    }
+    execute_object(fft, buffer, scratch);
+    for (size_t i = 0; i < fftsize; i++) {
+        real[i] = buffer[i].re;
+        imag[i] = buffer[i].im;
+    }
+}
+
+void execute_ifft(ifft_t* ifft, real_t* real, real_t* imag)
+{
+    execute_ifft_with_scratch(ifft, real, imag, ((fft_object_t*)ifft)->scratch);
+}
+
+void execute_ifft_with_scratch(const ifft_t* ifft, real_t* real, real_t* imag, complex_t* scratch)
+{
+    const fft_object_t* object = (const fft_object_t*)ifft;
+    complex_t* buffer = get_buffer(object, scratch);
+    const size_t fftsize = object->plan->fftsize;
+    double scale = fftsize;
+
+    for (size_t i = 0; i < fftsize; i++) {
+        buffer[i].re = real[i];
+        buffer[i].im = imag[i];
+    }
+    execute_object(ifft, buffer, scratch);
+    for (size_t i = 0; i < fftsize; i++) {
+        real[i] = buffer[i].re / scale;
+        imag[i] = buffer[i].im / scale;
+    }
+}
+
+void execute_rfft(rfft_t* rfft, const real_t* input, real_t* real, real_t* imag)
+{
+    execute_rfft_with_scratch(rfft, input, real, imag, ((fft_object_t*)rfft)->scratch);
+}
+
+void execute_rfft_with_scratch(const rfft_t* rfft, const real_t* input, real_t* real, real_t* imag, complex_t* scratch)
+{
+    const fft_object_t* object = (const fft_object_t*)rfft;
+    complex_t* buffer = get_buffer(object, scratch);
+    real_t* waveform = (real_t*)buffer;
+    const size_t fftsize = object->plan->fftsize;
+    const size_t numbins = fftsize / 2 + 1;
+
+    for (size_t i = 0; i < fftsize; i++) {
+        waveform[i] = input[i];
+    }
+    execute_object(rfft, buffer, scratch);
+    for (size_t k = 0; k < numbins; k++) {
+        real[k] = buffer[k].re;
+        imag[k] = buffer[k].im;
+    }
+}
+
+void execute_irfft(irfft_t* irfft, const real_t* real, const real_t* imag, real_t* output)
+{
+    execute_irfft_with_scratch(irfft, real, imag, output, ((fft_object_t*)irfft)->scratch);
+}
+
+void execute_irfft_with_scratch(const irfft_t* irfft, const real_t* real, const real_t* imag, real_t* output, complex_t* scratch)
+{
+    const fft_object_t* object = (const fft_object_t*)irfft;
+    complex_t* buffer = get_buffer(object, scratch);
+    const real_t* waveform = (const real_t*)buffer;
+    const size_t fftsize = object->plan->fftsize;
+    const size_t numbins = fftsize / 2 + 1;
+    double scale = fftsize;
+
+    for (size_t k = 0; k < numbins; k++) {
+        buffer[k].re = real[k];
+        buffer[k].im = imag[k];
+    }
+    execute_object(irfft, buffer, scratch);
+    for (size_t i = 0; i < fftsize; i++) {
+        output[i] = waveform[i] / scale;
+    }
+}
@@ -0,0 +1,535 @@
+// Native FFT: mixed-radix (2, 3, 4, 5) Stockham autosort FFT with SIMD butterflies
+// The instruction set is selected at runtime (cpu.h).
+#include "reim/fft.h"
+
+#include "reim/cpu.h"
+#include "reim/mathematics.h"
+#include "reim/memory.h"
+#include <assert.h>
+#include <stdbool.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NATIVE_FFT_X86
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define NATIVE_FFT_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define NATIVE_FFT_TARGET(isa) __attribute__((target(isa)))
+#else
+#define NATIVE_FFT_TARGET(isa)
+#endif
+
+// Maximum number of the stages (the radix is at least 2)
+#define NATIVE_FFT_MAX_STAGES 64
+
+// One stage of the Stockham algorithm with radix R (x and y may be the same when n == R)
+//   y[q + s(Rp + r)] = w^(rp) sum_l x[q + s(p + lm)] v^(rl)    (m = n / R, w = exp(-2 pi j / n), v = exp(-2 pi j / R))
+// twiddle: w^p, w^2p, ..., w^(R-1)p for each p
+// rotation: +1 for the forward transform, -1 for the inverse transform (w and v are conjugated)
+typedef void (*native_stage_t)(size_t n, size_t s, const complex_t* x, complex_t* y, const complex_t* twiddle, real_t rotation);
+
+typedef struct {
+    const char* name;
+    native_stage_t radix2;
+    native_stage_t radix3;
+    native_stage_t radix4;
+    native_stage_t radix5;
+} native_kernel_t;
+
+typedef struct {
+    size_t fftsize;                      // size of the real or complex transform
+    size_t length;                       // size of the complex transform
+    bool isreal;                         // real transform (complex transform of the half size + post/pre-processing)
+    bool inverse;                        // inverse transform
+    real_t rotation;                     // +1: multiply (-j) in the butterflies, -1: multiply (+j)
+    size_t stages;                       // number of the stages
+    size_t radix[NATIVE_FFT_MAX_STAGES]; // radix of each stage
+    complex_t* twiddle;                  // twiddle factors of all stages
+    complex_t* rotator;                  // exp(-2 pi j k / fftsize) (k = 0, ..., fftsize / 4) for the real transforms
+} native_fft_t;
+
+// sin(2 pi / 3), cos(2 pi / 5), cos(4 pi / 5), sin(2 pi / 5), sin(4 pi / 5)
+#define NATIVE_FFT_S3 0.86602540378443864676
+#define NATIVE_FFT_C51 0.30901699437494742410
+#define NATIVE_FFT_C52 -0.80901699437494742410
+#define NATIVE_FFT_S51 0.95105651629515357212
+#define NATIVE_FFT_S52 0.58778525229247312917
+
+// Scalar butterflies
+static inline complex_t multiply_scalar(real_t re, real_t im, complex_t w)
+{
+    const complex_t y = { re * w.re - im * w.im, im * w.re + re * w.im };
+    return y;
+}
+
+static void radix2_scalar(size_t n, size_t s, const complex_t* x, complex_t* y, const complex_t* twiddle, real_t rotation)
+{
+    const size_t m = n / 2;
+    (void)rotation;
+    for (size_t p = 0; p < m; p++) {
+        const complex_t w1 = twiddle[p];
+        const complex_t* x0 = x + s * p;
+        complex_t* y0 = y + s * 2 * p;
+        for (size_t q = 0; q < s; q++) {
+            const complex_t a = x0[q];
+            const complex_t b = x0[q + s * m];
+            y0[q].re = a.re + b.re;
+            y0[q].im = a.im + b.im;
+            y0[q + s] = multiply_scalar(a.re - b.re, a.im - b.im, w1);
+        }
+    }
+}
+
+static void radix3_scalar(size_t n, size_t s, const complex_t* x, complex_t* y, const complex_t* twiddle, real_t rotation)
+{
+    const size_t m = n / 3;
+    const real_t k = (real_t)NATIVE_FFT_S3 * rotation;
+    for (size_t p = 0; p < m; p++) {
+        const complex_t w1 = twiddle[2 * p + 0];
+        const complex_t w2 = twiddle[2 * p + 1];
+        const complex_t* x0 = x + s * p;
+        complex_t* y0 = y + s * 3 * p;
+        for (size_t q = 0; q < s; q++) {
+            const complex_t a = x0[q];
+            const complex_t b = x0[q + s * m];
+            const complex_t c = x0[q + s * 2 * m];
+            const real_t tr = b.re + c.re, ti = b.im + c.im;
+            const real_t ur = a.re - 0.5 * tr, ui = a.im - 0.5 * ti;
+            const real_t vr = k * (b.im - c.im), vi = -k * (b.re - c.re);
+            y0[q].re = a.re + tr;
+            y0[q].im = a.im + ti;
+            y0[q + s] = multiply_scalar(ur + vr, ui + vi, w1);
+            y0[q + s * 2] = multiply_scalar(ur - vr, ui - vi, w2);
+        }
+    }
+}
+
+static void radix4_scalar(size_t n, size_t s, const complex_t* x, complex_t* y, const complex_t* twiddle, real_t rotation)
+{
+    const size_t m = n / 4;
+    for (size_t p = 0; p < m; p++) {
+        const complex_t w1 = twiddle[3 * p + 0];
+        const complex_t w2 = twiddle[3 * p + 1];
+        const complex_t w3 = twiddle[3 * p + 2];
+        const complex_t* x0 = x + s * p;
+        complex_t* y0 = y + s * 4 * p;
+        for (size_t q = 0; q < s; q++) {
+            const complex_t a = x0[q];
+            const complex_t b = x0[q + s * m];
+            const complex_t c = x0[q + s * 2 * m];
+            const complex_t d = x0[q + s * 3 * m];
+            const real_t apcr = a.re + c.re, apci = a.im + c.im;
+            const real_t amcr = a.re - c.re, amci = a.im - c.im;
+            const real_t bpdr = b.re + d.re, bpdi = b.im + d.im;
+            const real_t rbmdr = rotation * (b.im - d.im), rbmdi = -rotation * (b.re - d.re);
+            y0[q].re = apcr + bpdr;
+            y0[q].im = apci + bpdi;
+            y0[q + s] = multiply_scalar(amcr + rbmdr, amci + rbmdi, w1);
+            y0[q + s * 2] = multiply_scalar(apcr - bpdr, apci - bpdi, w2);
+            y0[q + s * 3] = multiply_scalar(amcr - rbmdr, amci - rbmdi, w3);
+        }
+    }
+}
+
+static void radix5_scalar(size_t n, size_t s, const complex_t* x, complex_t* y, const complex_t* twiddle, real_t rotation)
+{
+    const size_t m = n / 5;
+    const real_t c1 = (real_t)NATIVE_FFT_C51, c2 = (real_t)NATIVE_FFT_C52;
+    const real_t s1 = (real_t)NATIVE_FFT_S51 * rotation, s2 = (real_t)NATIVE_FFT_S52 * rotation;
+    for (size_t p = 0; p < m; p++) {
+        const complex_t w1 = twiddle[4 * p + 0];
+        const complex_t w2 = twiddle[4 * p + 1];
+        const complex_t w3 = twiddle[4 * p + 2];
+        const complex_t w4 = twiddle[4 * p + 3];
+        const complex_t* x0 = x + s * p;
+        complex_t* y0 = y + s * 5 * p;
+        for (size_t q = 0; q < s; q++) {
+            const complex_t a = x0[q];
+            const complex_t b = x0[q + s * m];
+            const complex_t c = x0[q + s * 2 * m];
+            const complex_t d = x0[q + s * 3 * m];
+            const complex_t e = x0[q + s * 4 * m];
+            const real_t t1r = b.re + e.re, t1i = b.im + e.im;
+            const real_t t2r = c.re + d.re, t2i = c.im + d.im;
+            const real_t t3r = b.re - e.re, t3i = b.im - e.im;
+            const real_t t4r = c.re - d.re, t4i = c.im - d.im;
+            const real_t a1r = a.re + c1 * t1r + c2 * t2r, a1i = a.im + c1 * t1i + c2 * t2i;
+            const real_t a2r = a.re + c2 * t1r + c1 * t2r, a2i = a.im + c2 * t1i + c1 * t2i;
+            // (-j) (s1 t3 + s2 t4) and (-j) (s2 t3 - s1 t4)
+            const real_t b1r = s1 * t3i + s2 * t4i, b1i = -(s1 * t3r + s2 * t4r);
+            const real_t b2r = s2 * t3i - s1 * t4i, b2i = -(s2 * t3r - s1 * t4r);
+            y0[q].re = a.re + t1r + t2r;
+            y0[q].im = a.im + t1i + t2i;
+            y0[q + s] = multiply_scalar(a1r + b1r, a1i + b1i, w1);
+            y0[q + s * 2] = multiply_scalar(a2r + b2r, a2i + b2i, w2);
+            y0[q + s * 3] = multiply_scalar(a2r - b2r, a2i - b2i, w3);
+            y0[q + s * 4] = multiply_scalar(a1r - b1r, a1i - b1i, w4);
+        }
+    }
+}
+
+static const native_kernel_t kernel_scalar = { "native (scalar)", radix2_scalar, radix3_scalar, radix4_scalar, radix5_scalar };
+
+// SIMD butterflies
+#ifdef NATIVE_FFT_X86
+
+// SSE2
+#define KERNEL(name) name##_sse2
+#define KERNEL_NAME "native (SSE2)"
+#define KERNEL_TARGET NATIVE_FFT_TARGET("sse2")
+#ifdef REIM_USE_FLOAT
+#define VREAL __m128
+#define VLEN 2
+#define VLOAD(p) _mm_loadu_ps((const float*)(p))
+#define VSTORE(p, v) _mm_storeu_ps((float*)(p), v)
+#define VADD(a, b) _mm_add_ps(a, b)
+#define VSUB(a, b) _mm_sub_ps(a, b)
+#define VMUL(a, b) _mm_mul_ps(a, b)
+#define VMADD(a, b, c) _mm_add_ps(_mm_mul_ps(a, b), c)
+#define VSWAP(v) _mm_shuffle_ps(v, v, 0xB1)
+#define VSET1(x) _mm_set1_ps(x)
+#define VSET_RI(a, b) _mm_setr_ps(a, b, a, b)
+#else
+#define VREAL __m128d
+#define VLEN 1
+#define VLOAD(p) _mm_loadu_pd((const double*)(p))
+#define VSTORE(p, v) _mm_storeu_pd((double*)(p), v)
+#define VADD(a, b) _mm_add_pd(a, b)
+#define VSUB(a, b) _mm_sub_pd(a, b)
+#define VMUL(a, b) _mm_mul_pd(a, b)
+#define VMADD(a, b, c) _mm_add_pd(_mm_mul_pd(a, b), c)
+#define VSWAP(v) _mm_shuffle_pd(v, v, 0x1)
+#define VSET1(x) _mm_set1_pd(x)
+#define VSET_RI(a, b) _mm_setr_pd(a, b)
+#endif
+#include "fft_native_kernel.h"
+
+// AVX2 and FMA
+#define KERNEL(name) name##_avx2
+#define KERNEL_NAME "native (AVX2)"
+#define KERNEL_TARGET NATIVE_FFT_TARGET("avx2,fma")
+#ifdef REIM_USE_FLOAT
+#define VREAL __m256
+#define VLEN 4
+#define VLOAD(p) _mm256_loadu_ps((const float*)(p))
+#define VSTORE(p, v) _mm256_storeu_ps((float*)(p), v)
+#define VADD(a, b) _mm256_add_ps(a, b)
+#define VSUB(a, b) _mm256_sub_ps(a, b)
+#define VMUL(a, b) _mm256_mul_ps(a, b)
+#define VMADD(a, b, c) _mm256_fmadd_ps(a, b, c)
+#define VSWAP(v) _mm256_permute_ps(v, 0xB1)
+#define VSET1(x) _mm256_set1_ps(x)
+#define VSET_RI(a, b) _mm256_setr_ps(a, b, a, b, a, b, a, b)
+#else
+#define VREAL __m256d
+#define VLEN 2
+#define VLOAD(p) _mm256_loadu_pd((const double*)(p))
+#define VSTORE(p, v) _mm256_storeu_pd((double*)(p), v)
+#define VADD(a, b) _mm256_add_pd(a, b)
+#define VSUB(a, b) _mm256_sub_pd(a, b)
+#define VMUL(a, b) _mm256_mul_pd(a, b)
+#define VMADD(a, b, c) _mm256_fmadd_pd(a, b, c)
+#define VSWAP(v) _mm256_permute_pd(v, 0x5)
+#define VSET1(x) _mm256_set1_pd(x)
+#define VSET_RI(a, b) _mm256_setr_pd(a, b, a, b)
+#endif
+#include "fft_native_kernel.h"
+
+// AVX-512
+#define KERNEL(name) name##_avx512
+#define KERNEL_NAME "native (AVX-512)"
+#define KERNEL_TARGET NATIVE_FFT_TARGET("avx512f")
+#ifdef REIM_USE_FLOAT
+#define VREAL __m512
+#define VLEN 8
+#define VLOAD(p) _mm512_loadu_ps((const float*)(p))
+#define VSTORE(p, v) _mm512_storeu_ps((float*)(p), v)
+#define VADD(a, b) _mm512_add_ps(a, b)
+#define VSUB(a, b) _mm512_sub_ps(a, b)
+#define VMUL(a, b) _mm512_mul_ps(a, b)
+#define VMADD(a, b, c) _mm512_fmadd_ps(a, b, c)
+#define VSWAP(v) _mm512_permute_ps(v, 0xB1)
+#define VSET1(x) _mm512_set1_ps(x)
+#define VSET_RI(a, b) _mm512_set4_ps(b, a, b, a)
+#else
+#define VREAL __m512d
+#define VLEN 4
+#define VLOAD(p) _mm512_loadu_pd((const double*)(p))
+#define VSTORE(p, v) _mm512_storeu_pd((double*)(p), v)
+#define VADD(a, b) _mm512_add_pd(a, b)
+#define VSUB(a, b) _mm512_sub_pd(a, b)
+#define VMUL(a, b) _mm512_mul_pd(a, b)
+#define VMADD(a, b, c) _mm512_fmadd_pd(a, b, c)
+#define VSWAP(v) _mm512_permute_pd(v, 0x55)
+#define VSET1(x) _mm512_set1_pd(x)
+#define VSET_RI(a, b) _mm512_set4_pd(b, a, b, a)
+#endif
+#include "fft_native_kernel.h"
+
+#elif defined NATIVE_FFT_NEON
+
+// NEON (AArch64)
+#define KERNEL(name) name##_neon
+#define KERNEL_NAME "native (NEON)"
+#define KERNEL_TARGET
+#ifdef REIM_USE_FLOAT
+#define VREAL float32x4_t
+#define VLEN 2
+#define VLOAD(p) vld1q_f32((const float*)(p))
+#define VSTORE(p, v) vst1q_f32((float*)(p), v)
+#define VADD(a, b) vaddq_f32(a, b)
+#define VSUB(a, b) vsubq_f32(a, b)
+#define VMUL(a, b) vmulq_f32(a, b)
+#define VMADD(a, b, c) vfmaq_f32(c, a, b)
+#define VSWAP(v) vrev64q_f32(v)
+#define VSET1(x) vdupq_n_f32(x)
+#define VSET_RI(a, b) vld1q_f32((const float[4]) { a, b, a, b })
+#else
+#define VREAL float64x2_t
+#define VLEN 1
+#define VLOAD(p) vld1q_f64((const double*)(p))
+#define VSTORE(p, v) vst1q_f64((double*)(p), v)
+#define VADD(a, b) vaddq_f64(a, b)
+#define VSUB(a, b) vsubq_f64(a, b)
+#define VMUL(a, b) vmulq_f64(a, b)
+#define VMADD(a, b, c) vfmaq_f64(c, a, b)
+#define VSWAP(v) vextq_f64(v, v, 1)
+#define VSET1(x) vdupq_n_f64(x)
+#define VSET_RI(a, b) vld1q_f64((const double[2]) { a, b })
+#endif
+#include "fft_native_kernel.h"
+
+#endif
+
+// Kernels indexed by the instruction set (NULL: not built for the target)
+static const native_kernel_t* const native_kernels[CPU_ISA_COUNT] = {
+    [CPU_ISA_SCALAR] = &kernel_scalar,
+#ifdef NATIVE_FFT_X86
+    [CPU_ISA_SSE2] = &kernel_sse2,
+    [CPU_ISA_AVX2] = &kernel_avx2,
+    [CPU_ISA_AVX512] = &kernel_avx512,
+#elif defined NATIVE_FFT_NEON
+    [CPU_ISA_NEON] = &kernel_neon,
+#endif
+};
+
+// Kernel of the instruction set selected by get_kernel_isa() (looked up at each transform, the plans are shared)
+static const native_kernel_t* get_native_kernel()
+{
+    const native_kernel_t* kernel = native_kernels[get_kernel_isa()];
+    return (kernel != NULL) ? kernel : &kernel_scalar;
+}
+
+static void set_twiddle(complex_t* w, double angle)
+{
+    w->re = cos(angle);
+    w->im = sin(angle);
+}
+
+// Sizes of the form 2^a 3^b 5^c (even for the real transforms)
+bool is_native_fft_size(size_t fftsize, bool isreal)
+{
+    if (fftsize == 0 || (isreal && fftsize % 2 != 0)) {
+        return false;
+    }
+    const size_t factors[] = { 2, 3, 5 };
+    for (size_t i = 0; i < sizeof(factors) / sizeof(factors[0]); i++) {
+        while (fftsize % factors[i] == 0) {
+            fftsize /= factors[i];
+        }
+    }
+    return fftsize == 1;
+}
+
+// Factorize the length into the radices of the stages
+// The radix-4 (and radix-2) stages come first, so that the strides of the later stages are multiples of the vector length.
+static size_t factorize(size_t length, size_t* radix)
+{
+    size_t stages = 0;
+    while (length % 4 == 0) {
+        radix[stages++] = 4;
+        length /= 4;
+    }
+    if (length % 2 == 0) {
+        radix[stages++] = 2;
+        length /= 2;
+    }
+    while (length % 3 == 0) {
+        radix[stages++] = 3;
+        length /= 3;
+    }
+    while (length % 5 == 0) {
+        radix[stages++] = 5;
+        length /= 5;
+    }
+    return stages;
+}
+
+void* create_native_fft(size_t fftsize, bool isreal, bool inverse)
+{
+    assert(is_native_fft_size(fftsize, isreal));
+
+    native_fft_t* fft = REIM_ALLOC_SINGLE(native_fft_t);
+    const double sign = inverse ? +1.0 : -1.0;
+    fft->fftsize = fftsize;
+    fft->length = isreal ? fftsize / 2 : fftsize;
+    fft->isreal = isreal;
+    fft->inverse = inverse;
+    fft->rotation = inverse ? -1.0 : +1.0;
+    fft->stages = factorize(fft->length, fft->radix);
+
+    // twiddle factors of the stages (w^p, w^2p, ..., w^(R-1)p)
+    size_t count = 0;
+    size_t n = fft->length;
+    for (size_t i = 0; i < fft->stages; i++) {
+        count += (fft->radix[i] - 1) * (n / fft->radix[i]);
+        n /= fft->radix[i];
+    }
+    fft->twiddle = REIM_ALLOC(MAX(count, 1), complex_t);
+    complex_t* twiddle = fft->twiddle;
+    n = fft->length;
+    for (size_t i = 0; i < fft->stages; i++) {
+        const size_t radix = fft->radix[i];
+        for (size_t p = 0; p < n / radix; p++) {
+            for (size_t r = 1; r < radix; r++) {
+                set_twiddle(twiddle++, sign * 2.0 * REIM_PI * (double)(r * p) / n);
+            }
+        }
+        n /= radix;
+    }
+
+    // rotation factors for the real transforms
+    fft->rotator = NULL;
+    if (isreal) {
+        const size_t quarter = fftsize / 4;
+        fft->rotator = REIM_ALLOC(quarter + 1, complex_t);
+        for (size_t k = 0; k <= quarter; k++) {
+            set_twiddle(&fft->rotator[k], -2.0 * REIM_PI * (double)k / fftsize);
+        }
+    }
+
+    return fft;
+}
+
+void destroy_native_fft(void* native)
+{
+    native_fft_t* fft = (native_fft_t*)native;
+    REIM_FREE(fft->twiddle);
+    REIM_FREE(fft->rotator);
+    REIM_FREE(fft);
+}
+
+// Length of the work area for execute_native_fft()
+size_t get_native_fft_work_length(const void* native)
+{
+    return ((const native_fft_t*)native)->length;
+}
+
+const char* get_native_fft_kernel_name()
+{
+    return get_native_kernel()->name;
+}
+
+// Complex transform in-place (work: complex_t[length])
+static void execute_complex(const native_fft_t* fft, complex_t* data, complex_t* work)
+{
+    const native_kernel_t* kernel = get_native_kernel();
+    if (fft->stages == 0) {
+        return;
+    }
+
+    // ping-pong between data and work, then the last stage writes into data
+    // (the last stage can be performed in-place)
+    const complex_t* twiddle = fft->twiddle;
+    complex_t* x = data;
+    complex_t* y = work;
+    size_t n = fft->length, s = 1;
+    for (size_t i = 0; i < fft->stages; i++) {
+        const size_t radix = fft->radix[i];
+        const bool last = (i + 1 == fft->stages);
+        native_stage_t stage = kernel->radix2;
+        if (radix == 3) {
+            stage = kernel->radix3;
+        } else if (radix == 4) {
+            stage = kernel->radix4;
+        } else if (radix == 5) {
+            stage = kernel->radix5;
+        }
+        stage(n, s, x, last ? data : y, twiddle, fft->rotation);
+        twiddle += (radix - 1) * (n / radix);
+        n /= radix;
+        s *= radix;
+        complex_t* t = x;
+        x = y;
+        y = t;
+    }
+}
+
+// Real transform: complex transform of the even/odd samples, then separated into the half spectrum
+static void execute_real_forward(const native_fft_t* fft, complex_t* data, complex_t* work)
+{
+    const size_t half = fft->length;
+
+    execute_complex(fft, data, work);
+
+    // X[k] = E[k] + exp(-2 pi j k / N) O[k], E[k] = (Z[k] + Z*[h - k]) / 2, O[k] = -j (Z[k] - Z*[h - k]) / 2
+    const complex_t z0 = data[0];
+    for (size_t k = 1; k <= half / 2; k++) {
+        const complex_t z1 = data[k];
+        const complex_t z2 = data[half - k];
+        const complex_t w = fft->rotator[k];
+        const real_t er = 0.5 * (z1.re + z2.re), ei = 0.5 * (z1.im - z2.im);
+        const real_t odr = 0.5 * (z1.im + z2.im), odi = -0.5 * (z1.re - z2.re);
+        const real_t wor = w.re * odr - w.im * odi, woi = w.re * odi + w.im * odr;
+        data[k].re = er + wor;
+        data[k].im = ei + woi;
+        data[half - k].re = er - wor;
+        data[half - k].im = -(ei - woi);
+    }
+    data[0].re = z0.re + z0.im;
+    data[0].im = 0.0;
+    data[half].re = z0.re - z0.im;
+    data[half].im = 0.0;
+}
+
+// Inverse real transform: merged into the spectrum of the even/odd samples, then complex transform
+static void execute_real_backward(const native_fft_t* fft, complex_t* data, complex_t* work)
+{
+    const size_t half = fft->length;
+
+    // Z[k] = E[k] + j exp(2 pi j k / N) O[k], E[k] = X[k] + X*[h - k], O[k] = X[k] - X*[h - k]
+    // (scaled by 2 for the unnormalized result, the imaginary parts of DC and Nyquist are ignored)
+    const complex_t x0 = data[0];
+    const complex_t xh = data[half];
+    data[0].re = x0.re + xh.re;
+    data[0].im = x0.re - xh.re;
+    for (size_t k = 1; k <= half / 2; k++) {
+        const complex_t x1 = data[k];
+        const complex_t x2 = data[half - k];
+        const complex_t w = fft->rotator[k];
+        const real_t er = x1.re + x2.re, ei = x1.im - x2.im;
+        const real_t dr = x1.re - x2.re, di = x1.im + x2.im;
+        const real_t odr = w.re * dr + w.im * di, odi = w.re * di - w.im * dr;
+        data[k].re = er - odi;
+        data[k].im = ei + odr;
+        data[half - k].re = er + odi;
+        data[half - k].im = -(ei - odr);
+    }
+
+    execute_complex(fft, data, work);
+}
+
+void execute_native_fft(const void* native, complex_t* data, complex_t* work)
+{
+    const native_fft_t* fft = (const native_fft_t*)native;
+    if (!fft->isreal) {
+        execute_complex(fft, data, work);
+    } else if (!fft->inverse) {
+        execute_real_forward(fft, data, work);
+    } else {
+        execute_real_backward(fft, data, work);
+    }
+}
@@ -0,0 +1,170 @@
+// Butterflies of the native FFT for one instruction set (included by fft_native.c)
+//
+// The including file defines:
+//   KERNEL(name)   name with the suffix of the instruction set
+//   KERNEL_NAME    name reported by get_fft_library_name()
+//   KERNEL_TARGET  attributes to enable the instruction set
+//   VREAL          vector of VLEN interleaved complex values
+//   VLOAD(p), VSTORE(p, v), VADD(a, b), VSUB(a, b), VMUL(a, b)
+//   VMADD(a, b, c) a * b + c
+//   VSWAP(v)       swaps the real and imaginary parts
+//   VSET1(x)       (x, x, x, x, ...)
+//   VSET_RI(a, b)  (a, b, a, b, ...)
+
+// complex multiplication by a broadcasted value w
+KERNEL_TARGET static inline VREAL KERNEL(cmul)(VREAL x, complex_t w)
+{
+    return VMADD(x, VSET1(w.re), VMUL(VSWAP(x), VSET_RI(-w.im, w.im)));
+}
+
+// multiplication by (-j) * (k, k, ...) (r: (k, -k, ...))
+KERNEL_TARGET static inline VREAL KERNEL(rotate)(VREAL x, VREAL r)
+{
+    return VMUL(VSWAP(x), r);
+}
+
+// The first stages have too short inner loops for the vectors (s % VLEN != 0),
+// then the scalar butterflies are used.
+
+KERNEL_TARGET static void KERNEL(radix2)(size_t n, size_t s, const complex_t* x, complex_t* y, const complex_t* twiddle, real_t rotation)
+{
+    if (s % VLEN != 0) {
+        radix2_scalar(n, s, x, y, twiddle, rotation);
+        return;
+    }
+
+    const size_t m = n / 2;
+    for (size_t p = 0; p < m; p++) {
+        const complex_t w1 = twiddle[p];
+        const complex_t* x0 = x + s * p;
+        complex_t* y0 = y + s * 2 * p;
+        for (size_t q = 0; q < s; q += VLEN) {
+            const VREAL a = VLOAD(x0 + q);
+            const VREAL b = VLOAD(x0 + q + s * m);
+            VSTORE(y0 + q, VADD(a, b));
+            VSTORE(y0 + q + s, KERNEL(cmul)(VSUB(a, b), w1));
+        }
+    }
+}
+
+KERNEL_TARGET static void KERNEL(radix3)(size_t n, size_t s, const complex_t* x, complex_t* y, const complex_t* twiddle, real_t rotation)
+{
+    if (s % VLEN != 0) {
+        radix3_scalar(n, s, x, y, twiddle, rotation);
+        return;
+    }
+
+    const size_t m = n / 3;
+    const real_t k = (real_t)NATIVE_FFT_S3 * rotation;
+    const VREAL r = VSET_RI(k, -k);
+    const VREAL half = VSET1((real_t)0.5);
+    for (size_t p = 0; p < m; p++) {
+        const complex_t w1 = twiddle[2 * p + 0];
+        const complex_t w2 = twiddle[2 * p + 1];
+        const complex_t* x0 = x + s * p;
+        complex_t* y0 = y + s * 3 * p;
+        for (size_t q = 0; q < s; q += VLEN) {
+            const VREAL a = VLOAD(x0 + q);
+            const VREAL b = VLOAD(x0 + q + s * m);
+            const VREAL c = VLOAD(x0 + q + s * 2 * m);
+            const VREAL t = VADD(b, c);
+            const VREAL u = VSUB(a, VMUL(t, half));
+            const VREAL v = KERNEL(rotate)(VSUB(b, c), r);
+            VSTORE(y0 + q, VADD(a, t));
+            VSTORE(y0 + q + s, KERNEL(cmul)(VADD(u, v), w1));
+            VSTORE(y0 + q + s * 2, KERNEL(cmul)(VSUB(u, v), w2));
+        }
+    }
+}
+
+KERNEL_TARGET static void KERNEL(radix4)(size_t n, size_t s, const complex_t* x, complex_t* y, const complex_t* twiddle, real_t rotation)
+{
+    if (s % VLEN != 0) {
+        radix4_scalar(n, s, x, y, twiddle, rotation);
+        return;
+    }
+
+    const size_t m = n / 4;
+    const VREAL r = VSET_RI(rotation, -rotation);
+    for (size_t p = 0; p < m; p++) {
+        const complex_t w1 = twiddle[3 * p + 0];
+        const complex_t w2 = twiddle[3 * p + 1];
+        const complex_t w3 = twiddle[3 * p + 2];
+        const complex_t* x0 = x + s * p;
+        complex_t* y0 = y + s * 4 * p;
+        for (size_t q = 0; q < s; q += VLEN) {
+            const VREAL a = VLOAD(x0 + q);
+            const VREAL b = VLOAD(x0 + q + s * m);
+            const VREAL c = VLOAD(x0 + q + s * 2 * m);
+            const VREAL d = VLOAD(x0 + q + s * 3 * m);
+            const VREAL apc = VADD(a, c);
+            const VREAL amc = VSUB(a, c);
+            const VREAL bpd = VADD(b, d);
+            const VREAL rbmd = KERNEL(rotate)(VSUB(b, d), r);
+            VSTORE(y0 + q, VADD(apc, bpd));
+            VSTORE(y0 + q + s, KERNEL(cmul)(VADD(amc, rbmd), w1));
+            VSTORE(y0 + q + s * 2, KERNEL(cmul)(VSUB(apc, bpd), w2));
+            VSTORE(y0 + q + s * 3, KERNEL(cmul)(VSUB(amc, rbmd), w3));
+        }
+    }
+}
+
+KERNEL_TARGET static void KERNEL(radix5)(size_t n, size_t s, const complex_t* x, complex_t* y, const complex_t* twiddle, real_t rotation)
+{
+    if (s % VLEN != 0) {
+        radix5_scalar(n, s, x, y, twiddle, rotation);
+        return;
+    }
+
+    const size_t m = n / 5;
+    const real_t s1 = (real_t)NATIVE_FFT_S51 * rotation, s2 = (real_t)NATIVE_FFT_S52 * rotation;
+    const VREAL c1 = VSET1((real_t)NATIVE_FFT_C51);
+    const VREAL c2 = VSET1((real_t)NATIVE_FFT_C52);
+    const VREAL r1 = VSET_RI(s1, -s1);
+    const VREAL r2 = VSET_RI(s2, -s2);
+    for (size_t p = 0; p < m; p++) {
+        const complex_t w1 = twiddle[4 * p + 0];
+        const complex_t w2 = twiddle[4 * p + 1];
+        const complex_t w3 = twiddle[4 * p + 2];
+        const complex_t w4 = twiddle[4 * p + 3];
+        const complex_t* x0 = x + s * p;
+        complex_t* y0 = y + s * 5 * p;
+        for (size_t q = 0; q < s; q += VLEN) {
+            const VREAL a = VLOAD(x0 + q);
+            const VREAL b = VLOAD(x0 + q + s * m);
+            const VREAL c = VLOAD(x0 + q + s * 2 * m);
+            const VREAL d = VLOAD(x0 + q + s * 3 * m);
+            const VREAL e = VLOAD(x0 + q + s * 4 * m);
+            const VREAL t1 = VADD(b, e);
+            const VREAL t2 = VADD(c, d);
+            const VREAL t3 = VSUB(b, e);
+            const VREAL t4 = VSUB(c, d);
+            const VREAL a1 = VMADD(t2, c2, VMADD(t1, c1, a));
+            const VREAL a2 = VMADD(t2, c1, VMADD(t1, c2, a));
+            const VREAL b1 = VADD(KERNEL(rotate)(t3, r1), KERNEL(rotate)(t4, r2));
+            const VREAL b2 = VSUB(KERNEL(rotate)(t3, r2), KERNEL(rotate)(t4, r1));
+            VSTORE(y0 + q, VADD(a, VADD(t1, t2)));
+            VSTORE(y0 + q + s, KERNEL(cmul)(VADD(a1, b1), w1));
+            VSTORE(y0 + q + s * 2, KERNEL(cmul)(VADD(a2, b2), w2));
+            VSTORE(y0 + q + s * 3, KERNEL(cmul)(VSUB(a2, b2), w3));
+            VSTORE(y0 + q + s * 4, KERNEL(cmul)(VSUB(a1, b1), w4));
+        }
+    }
+}
+
+static const native_kernel_t KERNEL(kernel) = { KERNEL_NAME, KERNEL(radix2), KERNEL(radix3), KERNEL(radix4), KERNEL(radix5) };
+
+#undef KERNEL
+#undef KERNEL_NAME
+#undef KERNEL_TARGET
+#undef VREAL
+#undef VLEN
+#undef VLOAD
+#undef VSTORE
+#undef VADD
+#undef VSUB
+#undef VMUL
+#undef VMADD
+#undef VSWAP
+#undef VSET1
+#undef VSET_RI
@@ -281,11 +281,13 @@ Appendix :
     w[] and ip[] are compatible with all routines.
 */
 
-void cdft(int n, int isgn, double* a, int* ip, double* w)
+#include "reim/defines.h"
+
+void cdft(int n, int isgn, real_t* a, int* ip, real_t* w)
 {
-    void makewt(int nw, int* ip, double* w);
-    void cftfsub(int n, double* a, int* ip, int nw, double* w);
-    void cftbsub(int n, double* a, int* ip, int nw, double* w);
+    void makewt(int nw, int* ip, real_t* w);
+    void cftfsub(int n, real_t* a, int* ip, int nw, real_t* w);
+    void cftbsub(int n, real_t* a, int* ip, int nw, real_t* w);
     int nw;
 
     nw = ip[0];
@@ -300,16 +302,16 @@ void cdft(int n, int isgn, double* a, int* ip, double* w)
     }
 }
 
-void rdft(int n, int isgn, double* a, int* ip, double* w)
+void rdft(int n, int isgn, real_t* a, int* ip, real_t* w)
 {
-    void makewt(int nw, int* ip, double* w);
-    void makect(int nc, int* ip, double* c);
-    void cftfsub(int n, double* a, int* ip, int nw, double* w);
-    void cftbsub(int n, double* a, int* ip, int nw, double* w);
-    void rftfsub(int n, double* a, int nc, double* c);
-    void rftbsub(int n, double* a, int nc, double* c);
+    void makewt(int nw, int* ip, real_t* w);
+    void makect(int nc, int* ip, real_t* c);
+    void cftfsub(int n, real_t* a, int* ip, int nw, real_t* w);
+    void cftbsub(int n, real_t* a, int* ip, int nw, real_t* w);
+    void rftfsub(int n, real_t* a, int nc, real_t* c);
+    void rftbsub(int n, real_t* a, int nc, real_t* c);
     int nw, nc;
-    double xi;
+    real_t xi;
 
     nw = ip[0];
     if (n > (nw << 2)) {
@@ -343,17 +345,17 @@ void rdft(int n, int isgn, double* a, int* ip, double* w)
     }
 }
 
-void ddct(int n, int isgn, double* a, int* ip, double* w)
+void ddct(int n, int isgn, real_t* a, int* ip, real_t* w)
 {
-    void makewt(int nw, int* ip, double* w);
-    void makect(int nc, int* ip, double* c);
-    void cftfsub(int n, double* a, int* ip, int nw, double* w);
-    void cftbsub(int n, double* a, int* ip, int nw, double* w);
-    void rftfsub(int n, double* a, int nc, double* c);
-    void rftbsub(int n, double* a, int nc, double* c);
-    void dctsub(int n, double* a, int nc, double* c);
+    void makewt(int nw, int* ip, real_t* w);
+    void makect(int nc, int* ip, real_t* c);
+    void cftfsub(int n, real_t* a, int* ip, int nw, real_t* w);
+    void cftbsub(int n, real_t* a, int* ip, int nw, real_t* w);
+    void rftfsub(int n, real_t* a, int nc, real_t* c);
+    void rftbsub(int n, real_t* a, int nc, real_t* c);
+    void dctsub(int n, real_t* a, int nc, real_t* c);
     int j, nw, nc;
-    double xr;
+    real_t xr;
 
     nw = ip[0];
     if (n > (nw << 2)) {
@@ -398,17 +400,17 @@ void ddct(int n, int isgn, double* a, int* ip, double* w)
     }
 }
 
-void ddst(int n, int isgn, double* a, int* ip, double* w)
+void ddst(int n, int isgn, real_t* a, int* ip, real_t* w)
 {
-    void makewt(int nw, int* ip, double* w);
-    void makect(int nc, int* ip, double* c);
-    void cftfsub(int n, double* a, int* ip, int nw, double* w);
-    void cftbsub(int n, double* a, int* ip, int nw, double* w);
-    void rftfsub(int n, double* a, int nc, double* c);
-    void rftbsub(int n, double* a, int nc, double* c);
-    void dstsub(int n, double* a, int nc, double* c);
+    void makewt(int nw, int* ip, real_t* w);
+    void makect(int nc, int* ip, real_t* c);
+    void cftfsub(int n, real_t* a, int* ip, int nw, real_t* w);
+    void cftbsub(int n, real_t* a, int* ip, int nw, real_t* w);
+    void rftfsub(int n, real_t* a, int nc, real_t* c);
+    void rftbsub(int n, real_t* a, int nc, real_t* c);
+    void dstsub(int n, real_t* a, int nc, real_t* c);
     int j, nw, nc;
-    double xr;
+    real_t xr;
 
     nw = ip[0];
     if (n > (nw << 2)) {
@@ -453,15 +455,15 @@ void ddst(int n, int isgn, double* a, int* ip, double* w)
     }
 }
 
-void dfct(int n, double* a, double* t, int* ip, double* w)
+void dfct(int n, real_t* a, real_t* t, int* ip, real_t* w)
 {
-    void makewt(int nw, int* ip, double* w);
-    void makect(int nc, int* ip, double* c);
-    void cftfsub(int n, double* a, int* ip, int nw, double* w);
-    void rftfsub(int n, double* a, int nc, double* c);
-    void dctsub(int n, double* a, int nc, double* c);
+    void makewt(int nw, int* ip, real_t* w);
+    void makect(int nc, int* ip, real_t* c);
+    void cftfsub(int n, real_t* a, int* ip, int nw, real_t* w);
+    void rftfsub(int n, real_t* a, int nc, real_t* c);
+    void dctsub(int n, real_t* a, int nc, real_t* c);
     int j, k, l, m, mh, nw, nc;
-    double xr, xi, yr, yi;
+    real_t xr, xi, yr, yi;
 
     nw = ip[0];
     if (n > (nw << 3)) {
@@ -545,15 +547,15 @@ void dfct(int n, double* a, double* t, int* ip, double* w)
     }
 }
 
-void dfst(int n, double* a, double* t, int* ip, double* w)
+void dfst(int n, real_t* a, real_t* t, int* ip, real_t* w)
 {
-    void makewt(int nw, int* ip, double* w);
-    void makect(int nc, int* ip, double* c);
-    void cftfsub(int n, double* a, int* ip, int nw, double* w);
-    void rftfsub(int n, double* a, int nc, double* c);
-    void dstsub(int n, double* a, int nc, double* c);
+    void makewt(int nw, int* ip, real_t* w);
+    void makect(int nc, int* ip, real_t* c);
+    void cftfsub(int n, real_t* a, int* ip, int nw, real_t* w);
+    void rftfsub(int n, real_t* a, int nc, real_t* c);
+    void dstsub(int n, real_t* a, int nc, real_t* c);
     int j, k, l, m, mh, nw, nc;
-    double xr, xi, yr, yi;
+    real_t xr, xi, yr, yi;
 
     nw = ip[0];
     if (n > (nw << 3)) {
@@ -632,11 +634,12 @@ void dfst(int n, double* a, double* t, int* ip, double* w)
 
 #include <math.h>
 
-void makewt(int nw, int* ip, double* w)
+void makewt(int nw, int* ip, real_t* w)
 {
     void makeipt(int nw, int* ip);
     int j, nwh, nw0, nw1;
-    double delta, wn4r, wk1r, wk1i, wk3r, wk3i;
+    double delta; // the tables are calculated in double precision
+    real_t wn4r, wk1r, wk1i, wk3r, wk3i;
 
     ip[0] = nw;
     ip[1] = 1;
@@ -711,7 +714,7 @@ void makeipt(int nw, int* ip)
     }
 }
 
-void makect(int nc, int* ip, double* c)
+void makect(int nc, int* ip, real_t* c)
 {
     int j, nch;
     double delta;
@@ -787,21 +790,21 @@ void makect(int nc, int* ip, double* c)
     }
 #endif /* USE_CDFT_WINTHREADS */
 
-void cftfsub(int n, double* a, int* ip, int nw, double* w)
+void cftfsub(int n, real_t* a, int* ip, int nw, real_t* w)
 {
-    void bitrv2(int n, int* ip, double* a);
-    void bitrv216(double* a);
-    void bitrv208(double* a);
-    void cftf1st(int n, double* a, double* w);
-    void cftrec4(int n, double* a, int nw, double* w);
-    void cftleaf(int n, int isplt, double* a, int nw, double* w);
-    void cftfx41(int n, double* a, int nw, double* w);
-    void cftf161(double* a, double* w);
-    void cftf081(double* a, double* w);
-    void cftf040(double* a);
-    void cftx020(double* a);
+    void bitrv2(int n, int* ip, real_t* a);
+    void bitrv216(real_t* a);
+    void bitrv208(real_t* a);
+    void cftf1st(int n, real_t* a, real_t* w);
+    void cftrec4(int n, real_t* a, int nw, real_t* w);
+    void cftleaf(int n, int isplt, real_t* a, int nw, real_t* w);
+    void cftfx41(int n, real_t* a, int nw, real_t* w);
+    void cftf161(real_t* a, real_t* w);
+    void cftf081(real_t* a, real_t* w);
+    void cftf040(real_t* a);
+    void cftx020(real_t* a);
 #ifdef USE_CDFT_THREADS
-    void cftrec4_th(int n, double* a, int nw, double* w);
+    void cftrec4_th(int n, real_t* a, int nw, real_t* w);
 #endif /* USE_CDFT_THREADS */
 
     if (n > 8) {
@@ -834,21 +837,21 @@ void cftfsub(int n, double* a, int* ip, int nw, double* w)
     }
 }
 
-void cftbsub(int n, double* a, int* ip, int nw, double* w)
+void cftbsub(int n, real_t* a, int* ip, int nw, real_t* w)
 {
-    void bitrv2conj(int n, int* ip, double* a);
-    void bitrv216neg(double* a);
-    void bitrv208neg(double* a);
-    void cftb1st(int n, double* a, double* w);
-    void cftrec4(int n, double* a, int nw, double* w);
-    void cftleaf(int n, int isplt, double* a, int nw, double* w);
-    void cftfx41(int n, double* a, int nw, double* w);
-    void cftf161(double* a, double* w);
-    void cftf081(double* a, double* w);
-    void cftb040(double* a);
-    void cftx020(double* a);
+    void bitrv2conj(int n, int* ip, real_t* a);
+    void bitrv216neg(real_t* a);
+    void bitrv208neg(real_t* a);
+    void cftb1st(int n, real_t* a, real_t* w);
+    void cftrec4(int n, real_t* a, int nw, real_t* w);
+    void cftleaf(int n, int isplt, real_t* a, int nw, real_t* w);
+    void cftfx41(int n, real_t* a, int nw, real_t* w);
+    void cftf161(real_t* a, real_t* w);
+    void cftf081(real_t* a, real_t* w);
+    void cftb040(real_t* a);
+    void cftx020(real_t* a);
 #ifdef USE_CDFT_THREADS
-    void cftrec4_th(int n, double* a, int nw, double* w);
+    void cftrec4_th(int n, real_t* a, int nw, real_t* w);
 #endif /* USE_CDFT_THREADS */
 
     if (n > 8) {
@@ -881,10 +884,10 @@ void cftbsub(int n, double* a, int* ip, int nw, double* w)
     }
 }
 
-void bitrv2(int n, int* ip, double* a)
+void bitrv2(int n, int* ip, real_t* a)
 {
     int j, j1, k, k1, l, m, nh, nm;
-    double xr, xi, yr, yi;
+    real_t xr, xi, yr, yi;
 
     m = 1;
     for (l = n >> 2; l > 8; l >>= 2) {
@@ -1227,10 +1230,10 @@ void bitrv2(int n, int* ip, double* a)
     }
 }
 
-void bitrv2conj(int n, int* ip, double* a)
+void bitrv2conj(int n, int* ip, real_t* a)
 {
     int j, j1, k, k1, l, m, nh, nm;
-    double xr, xi, yr, yi;
+    real_t xr, xi, yr, yi;
 
     m = 1;
     for (l = n >> 2; l > 8; l >>= 2) {
@@ -1581,9 +1584,9 @@ void bitrv2conj(int n, int* ip, double* a)
     }
 }
 
-void bitrv216(double* a)
+void bitrv216(real_t* a)
 {
-    double x1r, x1i, x2r, x2i, x3r, x3i, x4r, x4i,
+    real_t x1r, x1i, x2r, x2i, x3r, x3i, x4r, x4i,
         x5r, x5i, x7r, x7i, x8r, x8i, x10r, x10i,
         x11r, x11i, x12r, x12i, x13r, x13i, x14r, x14i;
 
@@ -1637,9 +1640,9 @@ void bitrv216(double* a)
     a[29] = x7i;
 }
 
-void bitrv216neg(double* a)
+void bitrv216neg(real_t* a)
 {
-    double x1r, x1i, x2r, x2i, x3r, x3i, x4r, x4i,
+    real_t x1r, x1i, x2r, x2i, x3r, x3i, x4r, x4i,
         x5r, x5i, x6r, x6i, x7r, x7i, x8r, x8i,
         x9r, x9i, x10r, x10i, x11r, x11i, x12r, x12i,
         x13r, x13i, x14r, x14i, x15r, x15i;
@@ -1706,9 +1709,9 @@ void bitrv216neg(double* a)
     a[31] = x8i;
 }
 
-void bitrv208(double* a)
+void bitrv208(real_t* a)
 {
-    double x1r, x1i, x3r, x3i, x4r, x4i, x6r, x6i;
+    real_t x1r, x1i, x3r, x3i, x4r, x4i, x6r, x6i;
 
     x1r = a[2];
     x1i = a[3];
@@ -1728,9 +1731,9 @@ void bitrv208(double* a)
     a[13] = x3i;
 }
 
-void bitrv208neg(double* a)
+void bitrv208neg(real_t* a)
 {
-    double x1r, x1i, x2r, x2i, x3r, x3i, x4r, x4i,
+    real_t x1r, x1i, x2r, x2i, x3r, x3i, x4r, x4i,
         x5r, x5i, x6r, x6i, x7r, x7i;
 
     x1r = a[2];
@@ -1763,12 +1766,12 @@ void bitrv208neg(double* a)
     a[15] = x4i;
 }
 
-void cftf1st(int n, double* a, double* w)
+void cftf1st(int n, real_t* a, real_t* w)
 {
     int j, j0, j1, j2, j3, k, m, mh;
-    double wn4r, csc1, csc3, wk1r, wk1i, wk3r, wk3i,
+    real_t wn4r, csc1, csc3, wk1r, wk1i, wk3r, wk3i,
         wd1r, wd1i, wd3r, wd3i;
-    double x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i,
+    real_t x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i,
         y0r, y0i, y1r, y1i, y2r, y2i, y3r, y3i;
 
     mh = n >> 3;
@@ -1968,12 +1971,12 @@ void cftf1st(int n, double* a, double* w)
     a[j3 + 3] = wk3i * x0i - wk3r * x0r;
 }
 
-void cftb1st(int n, double* a, double* w)
+void cftb1st(int n, real_t* a, real_t* w)
 {
     int j, j0, j1, j2, j3, k, m, mh;
-    double wn4r, csc1, csc3, wk1r, wk1i, wk3r, wk3i,
+    real_t wn4r, csc1, csc3, wk1r, wk1i, wk3r, wk3i,
         wd1r, wd1i, wd3r, wd3i;
-    double x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i,
+    real_t x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i,
         y0r, y0i, y1r, y1i, y2r, y2i, y3r, y3i;
 
     mh = n >> 3;
@@ -2177,13 +2180,13 @@ void cftb1st(int n, double* a, double* w)
 struct cdft_arg_st {
     int n0;
     int n;
-    double* a;
+    real_t* a;
     int nw;
-    double* w;
+    real_t* w;
 };
 typedef struct cdft_arg_st cdft_arg_t;
 
-void cftrec4_th(int n, double* a, int nw, double* w)
+void cftrec4_th(int n, real_t* a, int nw, real_t* w)
 {
     void* cftrec1_th(void* p);
     void* cftrec2_th(void* p);
@@ -2218,11 +2221,11 @@ void cftrec4_th(int n, double* a, int nw, double* w)
 
 void* cftrec1_th(void* p)
 {
-    int cfttree(int n, int j, int k, double* a, int nw, double* w);
-    void cftleaf(int n, int isplt, double* a, int nw, double* w);
-    void cftmdl1(int n, double* a, double* w);
+    int cfttree(int n, int j, int k, real_t* a, int nw, real_t* w);
+    void cftleaf(int n, int isplt, real_t* a, int nw, real_t* w);
+    void cftmdl1(int n, real_t* a, real_t* w);
     int isplt, j, k, m, n, n0, nw;
-    double *a, *w;
+    real_t *a, *w;
 
     n0 = ((cdft_arg_t*)p)->n0;
     n = ((cdft_arg_t*)p)->n;
@@ -2246,11 +2249,11 @@ void* cftrec1_th(void* p)
 
 void* cftrec2_th(void* p)
 {
-    int cfttree(int n, int j, int k, double* a, int nw, double* w);
-    void cftleaf(int n, int isplt, double* a, int nw, double* w);
-    void cftmdl2(int n, double* a, double* w);
+    int cfttree(int n, int j, int k, real_t* a, int nw, real_t* w);
+    void cftleaf(int n, int isplt, real_t* a, int nw, real_t* w);
+    void cftmdl2(int n, real_t* a, real_t* w);
     int isplt, j, k, m, n, n0, nw;
-    double *a, *w;
+    real_t *a, *w;
 
     n0 = ((cdft_arg_t*)p)->n0;
     n = ((cdft_arg_t*)p)->n;
@@ -2275,11 +2278,11 @@ void* cftrec2_th(void* p)
 }
 #endif /* USE_CDFT_THREADS */
 
-void cftrec4(int n, double* a, int nw, double* w)
+void cftrec4(int n, real_t* a, int nw, real_t* w)
 {
-    int cfttree(int n, int j, int k, double* a, int nw, double* w);
-    void cftleaf(int n, int isplt, double* a, int nw, double* w);
-    void cftmdl1(int n, double* a, double* w);
+    int cfttree(int n, int j, int k, real_t* a, int nw, real_t* w);
+    void cftleaf(int n, int isplt, real_t* a, int nw, real_t* w);
+    void cftmdl1(int n, real_t* a, real_t* w);
     int isplt, j, k, m;
 
     m = n;
@@ -2296,10 +2299,10 @@ void cftrec4(int n, double* a, int nw, double* w)
     }
 }
 
-int cfttree(int n, int j, int k, double* a, int nw, double* w)
+int cfttree(int n, int j, int k, real_t* a, int nw, real_t* w)
 {
-    void cftmdl1(int n, double* a, double* w);
-    void cftmdl2(int n, double* a, double* w);
+    void cftmdl1(int n, real_t* a, real_t* w);
+    void cftmdl2(int n, real_t* a, real_t* w);
     int i, isplt, m;
 
     if ((k & 3) != 0) {
@@ -2330,14 +2333,14 @@ int cfttree(int n, int j, int k, double* a, int nw, double* w)
     return isplt;
 }
 
-void cftleaf(int n, int isplt, double* a, int nw, double* w)
+void cftleaf(int n, int isplt, real_t* a, int nw, real_t* w)
 {
-    void cftmdl1(int n, double* a, double* w);
-    void cftmdl2(int n, double* a, double* w);
-    void cftf161(double* a, double* w);
-    void cftf162(double* a, double* w);
-    void cftf081(double* a, double* w);
-    void cftf082(double* a, double* w);
+    void cftmdl1(int n, real_t* a, real_t* w);
+    void cftmdl2(int n, real_t* a, real_t* w);
+    void cftf161(real_t* a, real_t* w);
+    void cftf162(real_t* a, real_t* w);
+    void cftf081(real_t* a, real_t* w);
+    void cftf082(real_t* a, real_t* w);
 
     if (n == 512) {
         cftmdl1(128, a, &w[nw - 64]);
@@ -2394,11 +2397,11 @@ void cftleaf(int n, int isplt, double* a, int nw, double* w)
     }
 }
 
-void cftmdl1(int n, double* a, double* w)
+void cftmdl1(int n, real_t* a, real_t* w)
 {
     int j, j0, j1, j2, j3, k, m, mh;
-    double wn4r, wk1r, wk1i, wk3r, wk3i;
-    double x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+    real_t wn4r, wk1r, wk1i, wk3r, wk3i;
+    real_t x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 
     mh = n >> 3;
     m = 2 * mh;
@@ -2503,11 +2506,11 @@ void cftmdl1(int n, double* a, double* w)
     a[j3 + 1] = -wn4r * (x0i - x0r);
 }
 
-void cftmdl2(int n, double* a, double* w)
+void cftmdl2(int n, real_t* a, real_t* w)
 {
     int j, j0, j1, j2, j3, k, kr, m, mh;
-    double wn4r, wk1r, wk1i, wk3r, wk3i, wd1r, wd1i, wd3r, wd3i;
-    double x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i, y0r, y0i, y2r, y2i;
+    real_t wn4r, wk1r, wk1i, wk3r, wk3i, wd1r, wd1i, wd3r, wd3i;
+    real_t x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i, y0r, y0i, y2r, y2i;
 
     mh = n >> 3;
     m = 2 * mh;
@@ -2636,12 +2639,12 @@ void cftmdl2(int n, double* a, double* w)
     a[j3 + 1] = y0i + y2i;
 }
 
-void cftfx41(int n, double* a, int nw, double* w)
+void cftfx41(int n, real_t* a, int nw, real_t* w)
 {
-    void cftf161(double* a, double* w);
-    void cftf162(double* a, double* w);
-    void cftf081(double* a, double* w);
-    void cftf082(double* a, double* w);
+    void cftf161(real_t* a, real_t* w);
+    void cftf162(real_t* a, real_t* w);
+    void cftf081(real_t* a, real_t* w);
+    void cftf082(real_t* a, real_t* w);
 
     if (n == 128) {
         cftf161(a, &w[nw - 8]);
@@ -2656,9 +2659,9 @@ void cftfx41(int n, double* a, int nw, double* w)
     }
 }
 
-void cftf161(double* a, double* w)
+void cftf161(real_t* a, real_t* w)
 {
-    double wn4r, wk1r, wk1i,
+    real_t wn4r, wk1r, wk1i,
         x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i,
         y0r, y0i, y1r, y1i, y2r, y2i, y3r, y3i,
         y4r, y4i, y5r, y5i, y6r, y6i, y7r, y7i,
@@ -2814,9 +2817,9 @@ void cftf161(double* a, double* w)
     a[7] = x1i - x3r;
 }
 
-void cftf162(double* a, double* w)
+void cftf162(real_t* a, real_t* w)
 {
-    double wn4r, wk1r, wk1i, wk2r, wk2i, wk3r, wk3i,
+    real_t wn4r, wk1r, wk1i, wk2r, wk2i, wk3r, wk3i,
         x0r, x0i, x1r, x1i, x2r, x2i,
         y0r, y0i, y1r, y1i, y2r, y2i, y3r, y3i,
         y4r, y4i, y5r, y5i, y6r, y6i, y7r, y7i,
@@ -2996,9 +2999,9 @@ void cftf162(double* a, double* w)
     a[31] = x1i - x2r;
 }
 
-void cftf081(double* a, double* w)
+void cftf081(real_t* a, real_t* w)
 {
-    double wn4r, x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i,
+    real_t wn4r, x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i,
         y0r, y0i, y1r, y1i, y2r, y2i, y3r, y3i,
         y4r, y4i, y5r, y5i, y6r, y6i, y7r, y7i;
 
@@ -3057,9 +3060,9 @@ void cftf081(double* a, double* w)
     a[7] = y2i - y6r;
 }
 
-void cftf082(double* a, double* w)
+void cftf082(real_t* a, real_t* w)
 {
-    double wn4r, wk1r, wk1i, x0r, x0i, x1r, x1i,
+    real_t wn4r, wk1r, wk1i, x0r, x0i, x1r, x1i,
         y0r, y0i, y1r, y1i, y2r, y2i, y3r, y3i,
         y4r, y4i, y5r, y5i, y6r, y6i, y7r, y7i;
 
@@ -3128,9 +3131,9 @@ void cftf082(double* a, double* w)
     a[15] = x0i - x1r;
 }
 
-void cftf040(double* a)
+void cftf040(real_t* a)
 {
-    double x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+    real_t x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 
     x0r = a[0] + a[4];
     x0i = a[1] + a[5];
@@ -3150,9 +3153,9 @@ void cftf040(double* a)
     a[7] = x1i - x3r;
 }
 
-void cftb040(double* a)
+void cftb040(real_t* a)
 {
-    double x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+    real_t x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 
     x0r = a[0] + a[4];
     x0i = a[1] + a[5];
@@ -3172,9 +3175,9 @@ void cftb040(double* a)
     a[7] = x1i + x3r;
 }
 
-void cftx020(double* a)
+void cftx020(real_t* a)
 {
-    double x0r, x0i;
+    real_t x0r, x0i;
 
     x0r = a[0] - a[2];
     x0i = a[1] - a[3];
@@ -3184,10 +3187,10 @@ void cftx020(double* a)
     a[3] = x0i;
 }
 
-void rftfsub(int n, double* a, int nc, double* c)
+void rftfsub(int n, real_t* a, int nc, real_t* c)
 {
     int j, k, kk, ks, m;
-    double wkr, wki, xr, xi, yr, yi;
+    real_t wkr, wki, xr, xi, yr, yi;
 
     m = n >> 1;
     ks = 2 * nc / m;
@@ -3208,10 +3211,10 @@ void rftfsub(int n, double* a, int nc, double* c)
     }
 }
 
-void rftbsub(int n, double* a, int nc, double* c)
+void rftbsub(int n, real_t* a, int nc, real_t* c)
 {
     int j, k, kk, ks, m;
-    double wkr, wki, xr, xi, yr, yi;
+    real_t wkr, wki, xr, xi, yr, yi;
 
     m = n >> 1;
     ks = 2 * nc / m;
@@ -3232,10 +3235,10 @@ void rftbsub(int n, double* a, int nc, double* c)
     }
 }
 
-void dctsub(int n, double* a, int nc, double* c)
+void dctsub(int n, real_t* a, int nc, real_t* c)
 {
     int j, k, kk, ks, m;
-    double wkr, wki, xr;
+    real_t wkr, wki, xr;
 
     m = n >> 1;
     ks = nc / n;
@@ -3252,10 +3255,10 @@ void dctsub(int n, double* a, int nc, double* c)
     a[m] *= c[0];
 }
 
-void dstsub(int n, double* a, int nc, double* c)
+void dstsub(int n, real_t* a, int nc, real_t* c)
 {
     int j, k, kk, ks, m;
-    double wkr, wki, xr;
+    real_t wkr, wki, xr;
 
     m = n >> 1;
     ks = nc / n;
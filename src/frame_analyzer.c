@@ -0,0 +1,127 @@
+#include "reim/frame_analyzer.h"
+
+#include "reim/analyze_silence.h"
+#include "reim/memory.h"
+#include <assert.h>
+
+frame_analyzer_t* create_frame_analyzer(vocoder_context_t* vocoder, fo_context_t* fo_context, ap_context_t* ap_context,
+    sp_context_t* sp_context, size_t num_workers)
+{
+    worker_pool_t* pool = create_worker_pool(num_workers);
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    frame_analyzer_t* analyzer = REIM_ALLOC_SINGLE(frame_analyzer_t);
+    analyzer->vocoder = vocoder;
+    analyzer->fo_context = fo_context;
+    analyzer->ap_context = ap_context;
+    analyzer->sp_context = sp_context;
+    analyzer->sp_unvoiced = create_sp_context(vocoder);
+    analyzer->sp_buffer = allocate_vector(vocoder->numbins);
+    analyzer->pool = pool;
+    analyzer->silence_threshold = REIM_SILENCE_THRESHOLD;
+
+    analyzer->input = NULL;
+    analyzer->logarithmic = false;
+    analyzer->ap = NULL;
+    analyzer->sp = NULL;
+
+    analyzer->issilence = true;
+    analyzer->fo = 0.0;
+    analyzer->isvoiced = false;
+
+    return analyzer;
+}
+
+void destroy_frame_analyzer(frame_analyzer_t** analyzer)
+{
+    destroy_worker_pool(&(*analyzer)->pool);
+    destroy_sp_context(&(*analyzer)->sp_unvoiced);
+    free_vector((*analyzer)->sp_buffer);
+
+    REIM_FREE(*analyzer);
+    *analyzer = NULL;
+}
+
+// Tasks of the pool after the fo analysis
+enum {
+    FRAME_TASK_AP,          // aperiodicity and the voicing decision
+    FRAME_TASK_SP_VOICED,   // voiced spectral envelope
+    FRAME_TASK_SP_UNVOICED, // unvoiced spectral envelope
+    FRAME_TASK_COUNT,
+};
+
+static void analyze_frame_task(void* userdata, size_t index)
+{
+    frame_analyzer_t* analyzer = (frame_analyzer_t*)userdata;
+    vocoder_context_t* vocoder = analyzer->vocoder;
+    const bool logarithmic = analyzer->logarithmic;
+
+    switch (index) {
+    case FRAME_TASK_AP:
+        analyzer->isvoiced = analyze_ap(vocoder, analyzer->ap_context, analyzer->input, analyzer->fo, false, analyzer->ap);
+        break;
+    case FRAME_TASK_SP_VOICED:
+        if (logarithmic) {
+            analyze_sp_log(vocoder, analyzer->sp_context, analyzer->input, analyzer->fo, true, false, analyzer->sp);
+        } else {
+            analyze_sp(vocoder, analyzer->sp_context, analyzer->input, analyzer->fo, true, false, analyzer->sp);
+        }
+        break;
+    case FRAME_TASK_SP_UNVOICED:
+        if (logarithmic) {
+            analyze_sp_log(vocoder, analyzer->sp_unvoiced, analyzer->input, analyzer->fo, false, false, analyzer->sp_buffer);
+        } else {
+            analyze_sp(vocoder, analyzer->sp_unvoiced, analyzer->input, analyzer->fo, false, false, analyzer->sp_buffer);
+        }
+        break;
+    default:
+        assert(false);
+    }
+}
+
+static void analyze_frame_with_scale(frame_analyzer_t* analyzer, const real_t* input, const real_t* input_delayed,
+    bool logarithmic, real_t* ap, real_t* sp)
+{
+    vocoder_context_t* vocoder = analyzer->vocoder;
+    const size_t numbins = vocoder->numbins;
+
+    analyzer->input = input;
+    analyzer->logarithmic = logarithmic;
+    analyzer->ap = ap;
+    analyzer->sp = sp;
+
+    analyzer->issilence = analyze_silence(vocoder, input, analyzer->silence_threshold);
+    analyzer->fo = analyze_fo_with_pool(vocoder, analyzer->fo_context, input, input_delayed, analyzer->pool);
+
+    // The spectral envelope of both the voicing decisions (the one of the silence and the fo out of range is unvoiced)
+    // Without the workers, the extra envelope would only cost time.
+    const bool is_decided = analyzer->issilence || analyzer->fo < vocoder->fo_floor || analyzer->fo > vocoder->fo_ceil;
+    if (is_decided || analyzer->pool->num_workers == 0) {
+        analyzer->isvoiced = analyze_ap(vocoder, analyzer->ap_context, input, analyzer->fo, analyzer->issilence, ap);
+        if (logarithmic) {
+            analyze_sp_log(vocoder, analyzer->sp_context, input, analyzer->fo, analyzer->isvoiced, analyzer->issilence, sp);
+        } else {
+            analyze_sp(vocoder, analyzer->sp_context, input, analyzer->fo, analyzer->isvoiced, analyzer->issilence, sp);
+        }
+        return;
+    }
+
+    run_worker_pool(analyzer->pool, analyze_frame_task, analyzer, FRAME_TASK_COUNT);
+    if (!analyzer->isvoiced) {
+        for (size_t k = 0; k < numbins; k++) {
+            sp[k] = analyzer->sp_buffer[k];
+        }
+    }
+}
+
+void analyze_frame(frame_analyzer_t* analyzer, const real_t* input, const real_t* input_delayed, real_t* ap, real_t* sp)
+{
+    analyze_frame_with_scale(analyzer, input, input_delayed, false, ap, sp);
+}
+
+void analyze_frame_log(frame_analyzer_t* analyzer, const real_t* input, const real_t* input_delayed, real_t* ap, real_t* sp_log)
+{
+    analyze_frame_with_scale(analyzer, input, input_delayed, true, ap, sp_log);
+}
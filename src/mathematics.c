@@ -24,7 +24,16 @@ double generate_uniform_random(random_state_t state)
     return (double)state[0] / UINT32_MAX;
 }
 
-void ifftshift(const double* source, double* destination, size_t numbins)
+size_t get_next_pow2(size_t x)
+{
+    size_t n = 1;
+    while (n < x) {
+        n <<= 1;
+    }
+    return n;
+}
+
+void ifftshift(const real_t* source, real_t* destination, size_t numbins)
 {
     for (size_t k = 0; k < numbins - 1; k++) {
         destination[k] = source[numbins - 1 + k];
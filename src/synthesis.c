@@ -2,79 +2,156 @@
 
 #include "reim/mathematics.h"
 #include "reim/memory.h"
-
-static void generate_minimum_phase_spectrum(double* spec_r, double* spec_i, double gain, size_t fftsize, fft_t* fft, ifft_t* ifft)
+#include "reim/vmath.h"
+
+// Log spectrum of the minimum phase filter from the log power spectrum (spec[k].re, including the normalization of the IFFT)
+// The real part is the log amplitude, and the imaginary part is the phase.
+// The cepstrum of the even log spectrum is its DCT-I, and the causal part of the cepstrum gives
+// the half of the log spectrum (the real part) and the negative half of the DST-I (the imaginary part).
+// cepstrum: work area (real_t[fftsize / 2 + 1])
+static void generate_minimum_phase_log_spectrum(complex_t* spec, size_t fftsize, real_t* cepstrum,
+    const dct_t* dct, const dst_t* dst, complex_t* scratch)
 {
     const size_t numbins = fftsize / 2 + 1;
 
     // cepstrum
-    for (size_t k = 0; k < fftsize; k++) {
-        spec_r[k] = log(spec_r[k] + 1e-12);
-        spec_i[k] = 0.0;
-    }
-    execute_ifft(ifft, spec_r, spec_i);
-
-    // liftering
-    spec_r[0] *= 0.5;
-    spec_i[0] *= 0.5;
-    spec_r[numbins - 1] *= 0.5;
-    spec_i[numbins - 1] *= 0.5;
-    for (size_t k = numbins; k < fftsize; k++) {
-        spec_r[k] = spec_i[k] = 0.0;
+    for (size_t k = 0; k < numbins; k++) {
+        cepstrum[k] = spec[k].re;
     }
+    execute_dct_inplace_with_scratch(dct, cepstrum, scratch);
 
-    // complex spectrum
-    execute_fft(fft, spec_r, spec_i);
+    // complex log spectrum
+    execute_dst_inplace_with_scratch(dst, cepstrum, scratch);
+    const double scale = 0.5 * fftsize;
     for (size_t k = 0; k < numbins; k++) {
-        const double a = gain * exp(spec_r[k]);
-        const double b = spec_i[k];
-        spec_r[k] = a * cos(b);
-        spec_i[k] = a * sin(b);
+        spec[k].re *= scale;
+        spec[k].im = -0.5 * cepstrum[k];
     }
-    for (size_t k = 0; k < numbins - 2; k++) {
-        spec_r[numbins + k] = spec_r[numbins - 2 - k];
-        spec_i[numbins + k] = -spec_i[numbins - 2 - k];
+}
+
+// spec = gain * exp(spec.re + i spec.im), through the blocks of the separate arrays for the vector math
+#define SYNTHESIS_VMATH_BLOCK 64
+
+static void log_to_complex_spectrum(complex_t* spec, size_t numbins, double gain)
+{
+    real_t a[SYNTHESIS_VMATH_BLOCK], s[SYNTHESIS_VMATH_BLOCK], c[SYNTHESIS_VMATH_BLOCK];
+    for (size_t offset = 0; offset < numbins; offset += SYNTHESIS_VMATH_BLOCK) {
+        const size_t length = MIN(numbins - offset, SYNTHESIS_VMATH_BLOCK);
+        for (size_t k = 0; k < length; k++) {
+            a[k] = spec[offset + k].re;
+            s[k] = spec[offset + k].im;
+        }
+        vexp(a, a, length);
+        vsincos(s, s, c, length);
+        for (size_t k = 0; k < length; k++) {
+            const double magnitude = gain * a[k];
+            spec[offset + k].re = magnitude * c[k];
+            spec[offset + k].im = magnitude * s[k];
+        }
     }
 }
 
-static void generate_impulse(double* impulse, const double* spec_r, const double* spec_i, double shift,
-    const double* window, double* temp_r, double* temp_i,
-    size_t fftsize, ifft_t* ifft)
+// Minimum phase filter from the log power spectrum (spec[k].re)
+static void generate_minimum_phase_spectrum(complex_t* spec, size_t fftsize, real_t* cepstrum,
+    const dct_t* dct, const dst_t* dst, complex_t* scratch)
 {
     const size_t numbins = fftsize / 2 + 1;
 
-    if (shift == 0.0) {
-        // zero shift spectrum
-        for (size_t k = 0; k < fftsize; k++) {
-            temp_r[k] = spec_r[k];
-            temp_i[k] = spec_i[k];
-        }
-    } else {
-        // time shifted spectrum
-        for (size_t k = 0; k < numbins; k++) {
-            const double omega = -REIM_PI * shift * (double)k / (numbins - 1);
-            temp_r[k] = cos(omega);
-            temp_i[k] = sin(omega);
-        }
-        for (size_t k = 0; k < numbins - 2; k++) {
-            temp_r[numbins + k] = temp_r[numbins - 2 - k];
-            temp_i[numbins + k] = -temp_i[numbins - 2 - k];
+    // log power spectrum (including the normalization of the IFFT)
+    const double scale = 1.0 / fftsize;
+    for (size_t k = 0; k < numbins; k++) {
+        spec[k].re *= scale;
+    }
+    generate_minimum_phase_log_spectrum(spec, fftsize, cepstrum, dct, dst, scratch);
+
+    // complex spectrum
+    log_to_complex_spectrum(spec, numbins, 1.0);
+}
+
+// Aperiodicity corrections of the minimum phase filters (low-order cepstrum of the power gains of the components)
+#define SYNTHESIS_AP_FFTSIZE 128
+#define SYNTHESIS_AP_NUMBINS (SYNTHESIS_AP_FFTSIZE / 2 + 1)
+
+static bool is_flat_aperiodicity(const real_t* ap, size_t numbins)
+{
+    for (size_t k = 1; k < numbins; k++) {
+        if (ap[k] != ap[0]) {
+            return false;
         }
-        for (size_t k = 0; k < fftsize; k++) {
-            const double xr1 = temp_r[k];
-            const double xi1 = temp_i[k];
-            const double xr2 = spec_r[k];
-            const double xi2 = spec_i[k];
-            temp_r[k] = xr1 * xr2 - xi1 * xi2;
-            temp_i[k] = xr1 * xi2 + xi1 * xr2;
+    }
+    return true;
+}
+
+// Minimum phase filter of the power gain of the component (periodic: 1 - ap^2, aperiodic: ap^2) on the coarse bins
+// The gain is averaged over the bins of the FFT size around each coarse bin.
+static void generate_aperiodicity_correction(complex_t* correction, const real_t* ap, bool periodic, double gain,
+    size_t numbins, const dct_t* dct, const dst_t* dst, complex_t* scratch)
+{
+    real_t cepstrum[SYNTHESIS_AP_NUMBINS];
+    const double step = (double)(numbins - 1) / (SYNTHESIS_AP_NUMBINS - 1);
+    const double scale = 1.0 / SYNTHESIS_AP_FFTSIZE;
+    for (size_t j = 0; j < SYNTHESIS_AP_NUMBINS; j++) {
+        const size_t first = MIN((j > 0) ? (size_t)ceil((j - 0.5) * step) : 0, numbins - 1);
+        const size_t last = MAX(MIN((size_t)ceil((j + 0.5) * step), numbins), first + 1);
+        double sum = 0.0;
+        for (size_t k = first; k < last; k++) {
+            sum += ap[k] * ap[k];
         }
+        const double aper = sum / (last - first);
+        cepstrum[j] = (periodic ? 1.0 - aper : aper) + 1e-12;
+    }
+    vlog(cepstrum, cepstrum, SYNTHESIS_AP_NUMBINS);
+    for (size_t j = 0; j < SYNTHESIS_AP_NUMBINS; j++) {
+        correction[j].re = cepstrum[j] * scale;
+    }
+    generate_minimum_phase_log_spectrum(correction, SYNTHESIS_AP_FFTSIZE, cepstrum, dct, dst, scratch);
+
+    log_to_complex_spectrum(correction, SYNTHESIS_AP_NUMBINS, gain);
+}
+
+// Multiply the spectrum by the correction interpolated linearly to the bins of the FFT size
+static void apply_aperiodicity_correction(complex_t* output, const complex_t* spec, const complex_t* correction, size_t numbins)
+{
+    const double step = (double)(numbins - 1) / (SYNTHESIS_AP_NUMBINS - 1);
+    for (size_t k = 0; k < numbins; k++) {
+        const double position = k / step;
+        const size_t index = MIN((size_t)position, SYNTHESIS_AP_NUMBINS - 2);
+        const double delta = position - index;
+        const double xr = (1.0 - delta) * correction[index].re + delta * correction[index + 1].re;
+        const double xi = (1.0 - delta) * correction[index].im + delta * correction[index + 1].im;
+        const double yr = spec[k].re;
+        const double yi = spec[k].im;
+        output[k].re = xr * yr - xi * yi;
+        output[k].im = xr * yi + xi * yr;
+    }
+}
+
+// Fractional delay filters for the periodic excitation (windowed sinc, polyphase)
+#define SYNTHESIS_DELAY_TAPS 32
+#define SYNTHESIS_DELAY_PHASES 64
+
+// minimum span of the window to remove DC from the truncated impulse response (relative to the FFT size)
+#define SYNTHESIS_DC_SPAN 0.25
+
+static void render_impulse(real_t* impulse, const complex_t* spec,
+    complex_t* temp, size_t fftsize, const irfft_t* irfft, complex_t* scratch)
+{
+    const size_t numbins = fftsize / 2 + 1;
+
+    // spectra are scaled for the normalization of the IFFT
+    const double scale = 1.0 / fftsize;
+    for (size_t k = 0; k < numbins; k++) {
+        temp[k].re = spec[k].re * scale;
+        temp[k].im = spec[k].im * scale;
     }
 
     // generate impulse response
-    execute_ifft(ifft, temp_r, temp_i);
-    ifftshift(temp_r, impulse, numbins);
+    execute_irfft_inplace_with_scratch(irfft, temp, scratch);
+    ifftshift((const real_t*)temp, impulse, numbins);
+}
 
-    // remove DC component
+static void remove_dc(real_t* impulse, const real_t* window, size_t fftsize)
+{
     double gain = 0;
     for (size_t k = 0; k < fftsize; k++) {
         gain += impulse[k];
@@ -84,6 +161,211 @@ static void generate_impulse(double* impulse, const double* spec_r, const double
     }
 }
 
+// Truncate the impulse response (before removing DC) to the samples from the onset (fftsize / 2)
+// which hold (1 - tolerance) of the energy, then taper the end over a quarter of them.
+// Returns the length from the onset, or 0 if the response is not truncated (it needs the wrapped part).
+static size_t truncate_impulse(real_t* impulse, size_t fftsize, double tolerance)
+{
+    const size_t half = fftsize / 2;
+    if (tolerance <= 0.0) {
+        return 0;
+    }
+
+    double total = 0.0;
+    for (size_t n = 0; n < fftsize; n++) {
+        total += impulse[n] * impulse[n];
+    }
+    const double target = (1.0 - tolerance) * total;
+    double sum = 0.0;
+    size_t length = half;
+    for (size_t n = half; n < fftsize; n++) {
+        sum += impulse[n] * impulse[n];
+        if (sum >= target) {
+            length = n - half + 1;
+            break;
+        }
+    }
+    const size_t taper = MIN(MAX(length / 4, 16), half - length);
+    if (length + taper >= half) {
+        return 0;
+    }
+
+    // raised cosine taper
+    for (size_t n = 0; n < taper; n++) {
+        impulse[half + length + n] *= 0.5 + 0.5 * cos(REIM_PI * (n + 1) / (taper + 1));
+    }
+    length += taper;
+    for (size_t n = 0; n < half; n++) {
+        impulse[n] = 0.0;
+    }
+    for (size_t n = half + length; n < fftsize; n++) {
+        impulse[n] = 0.0;
+    }
+    return length;
+}
+
+// Window to remove DC within the truncated impulse response (the window of the FFT size resampled to the length)
+static void resample_window(real_t* output, const real_t* window, size_t length, size_t fftsize)
+{
+    if (length == fftsize) {
+        for (size_t n = 0; n < fftsize; n++) {
+            output[n] = window[n];
+        }
+        return;
+    }
+
+    double sum = 0.0;
+    for (size_t n = 0; n < length; n++) {
+        const double position = ((double)n + 0.5) * fftsize / length - 0.5;
+        const size_t index = MIN((size_t)position, fftsize - 2);
+        const double delta = position - index;
+        output[n] = (1.0 - delta) * window[index] + delta * window[index + 1];
+        sum += output[n];
+    }
+    for (size_t n = 0; n < length; n++) {
+        output[n] /= sum;
+    }
+}
+
+// Truncate the impulse response of the frame, and set the samples to write with the margin on both sides
+// The window to remove DC spans SYNTHESIS_DC_SPAN of the FFT size at least (the shorter window leaks DC into the band).
+static void set_impulse_support(impulse_support_t* support, real_t* impulse, const real_t* window,
+    size_t fftsize, double tolerance, size_t margin)
+{
+    const size_t half = fftsize / 2;
+    const size_t length = truncate_impulse(impulse, fftsize, tolerance);
+    if (length > 0) {
+        support->response_offset = half - MIN(margin, half);
+        support->response_length = MIN(length + 2 * margin, fftsize - support->response_offset);
+        const size_t span = MAX(length, (size_t)(SYNTHESIS_DC_SPAN * fftsize));
+        const size_t before = MIN(span / 2 + margin, half);
+        support->offset = half - before;
+        support->length = MIN(before + span + margin, fftsize - support->offset);
+    } else {
+        support->response_offset = 0;
+        support->response_length = fftsize;
+        support->offset = 0;
+        support->length = fftsize;
+    }
+    resample_window(support->window, window, support->length, fftsize);
+}
+
+// Delay the impulse response by the fraction of the sample (shift: [0, 1))
+// The filter is interpolated between the neighboring phases of the bank, and only the samples of the support are written
+// (the response is computed within its samples, and the rest is zero).
+static void delay_impulse(real_t* impulse, const real_t* source, double shift,
+    const real_t* bank, real_t* filter, size_t fftsize, const impulse_support_t* support)
+{
+    const double position = shift * SYNTHESIS_DELAY_PHASES;
+    const size_t phase = MIN((size_t)position, SYNTHESIS_DELAY_PHASES - 1);
+    const double delta = position - phase;
+    const real_t* filter1 = bank + phase * SYNTHESIS_DELAY_TAPS;
+    const real_t* filter2 = filter1 + SYNTHESIS_DELAY_TAPS;
+    for (size_t k = 0; k < SYNTHESIS_DELAY_TAPS; k++) {
+        filter[k] = (1.0 - delta) * filter1[k] + delta * filter2[k];
+    }
+
+    // impulse[n] = sum_k filter[k] * source[n - k + center] (zeros outside of the source)
+    const size_t center = SYNTHESIS_DELAY_TAPS / 2 - 1;
+    const size_t offset = support->response_offset;
+    const size_t length = support->response_length;
+    for (size_t n = support->offset; n < support->offset + support->length; n++) {
+        impulse[n] = 0.0;
+    }
+    for (size_t k = 0; k < SYNTHESIS_DELAY_TAPS; k++) {
+        const real_t h = filter[k];
+        const size_t first = MAX((k > center) ? k - center : 0, offset);
+        const size_t last = MIN((k > center) ? fftsize : fftsize - (center - k), offset + length);
+        const real_t* x = source + (first + center - k);
+        real_t* y = impulse + first;
+        for (size_t n = 0; n + first < last; n++) {
+            y[n] += h * x[n];
+        }
+    }
+}
+
+// Advance the velvet noise by a sample (returns true at the excitation)
+static bool next_velvet_noise(synthesis_context_t* context)
+{
+    const bool excitation = (context->noise_int == context->interval_random);
+    if (context->noise_int == context->interval_velvet - 1) {
+        // update excitation position
+        const double r = generate_uniform_random(context->random);
+        context->interval_random = (size_t)floor(r * (context->interval_velvet - 1));
+        context->noise_int = 0;
+    }
+    context->noise_int++;
+    return excitation;
+}
+
+// Render the aperiodic component of the next samples at once (block mode)
+// The velvet noise sequence is circularly convolved with the impulse response (not truncated) in the FFT size.
+// The tails of the DC removal windows wrapped around are moved after the end, and the sequence is kept
+// within a quarter of the FFT size, so that the other wrapped part is the tail of the minimum phase response.
+static void render_velvet_noise(vocoder_context_t* vocoder, synthesis_context_t* context)
+{
+    const size_t fftsize = vocoder->fftsize;
+    const size_t numbins = vocoder->numbins;
+    const size_t span = fftsize / 4;
+
+    // the samples already rendered are skipped, and the rest of the frame is rendered later if it exceeds the span
+    const size_t offset = context->noise_rendered;
+    const size_t length = (offset < span) ? MIN(context->noise_pending, span - offset) : 0;
+    if (length == 0) {
+        return;
+    }
+
+    // velvet noise sequence, and the sum of the wrapped tails of the windows
+    real_t* velvet = (real_t*)context->temp;
+    real_t* wrapped = context->impulse_velvet + fftsize;
+    for (size_t n = 0; n < fftsize; n++) {
+        velvet[n] = 0.0;
+    }
+    for (size_t n = 0; n < span; n++) {
+        wrapped[n] = 0.0;
+    }
+    for (size_t t = offset; t < offset + length; t++) {
+        if (next_velvet_noise(context)) {
+            const real_t* tail = context->window + fftsize - t;
+            for (size_t n = 0; n < t; n++) {
+                wrapped[n] += tail[n];
+            }
+            velvet[t] = 1.0;
+        }
+    }
+
+    // filtering: the spectrum of the impulse response is (-1)^k X[k] (ifftshift) - X[0] W[k] (DC removal)
+    // (including the normalization of the IFFT)
+    execute_rfft_inplace_with_scratch(vocoder->rfft, context->temp, context->scratch);
+    const double gain = context->spec_noise[0].re;
+    const double scale = 1.0 / fftsize;
+    for (size_t k = 0; k < numbins; k++) {
+        const double sign = (k % 2 == 0) ? 1.0 : -1.0;
+        const double xr1 = context->temp[k].re;
+        const double xi1 = context->temp[k].im;
+        const double xr2 = (sign * context->spec_noise[k].re - gain * context->spec_window[k].re) * scale;
+        const double xi2 = (sign * context->spec_noise[k].im - gain * context->spec_window[k].im) * scale;
+        context->temp[k].re = xr1 * xr2 - xi1 * xi2;
+        context->temp[k].im = xr1 * xi2 + xi1 * xr2;
+    }
+    execute_irfft_inplace_with_scratch(vocoder->irfft, context->temp, context->scratch);
+
+    // move the wrapped tails of the windows
+    real_t* waveform = (real_t*)context->temp;
+    for (size_t n = 0; n < span; n++) {
+        context->impulse_velvet[n] = waveform[n] + gain * wrapped[n];
+        wrapped[n] *= -gain;
+    }
+    for (size_t n = span; n < fftsize; n++) {
+        context->impulse_velvet[n] = waveform[n];
+    }
+
+    // write the waveform
+    push_additive_circular_queue(context->buffer, context->impulse_velvet, fftsize + span);
+    context->noise_rendered = offset + length;
+    context->noise_pending -= length;
+}
+
 static double vorbis_window(double index, double fftsize)
 {
     double wt = REIM_PI * (index + 0.5) / fftsize;
@@ -91,20 +373,26 @@ static double vorbis_window(double index, double fftsize)
     return sin(REIM_PI / 2 * s * s);
 }
 
-synthesis_context_t* create_synthesis_context(const vocoder_context_t* vocoder)
+static synthesis_context_t* create_synthesis_context_with_mode(const vocoder_context_t* vocoder, bool noise_block)
 {
     synthesis_context_t* context = REIM_ALLOC_SINGLE(synthesis_context_t);
     const double fs = vocoder->fs;
     const double fo_floor = vocoder->fo_floor;
     const size_t fftsize = vocoder->fftsize;
+    const size_t numbins = vocoder->numbins;
 
     context->has_pulse = false;
     context->has_noise = false;
 
-    context->spec_pulse_r = allocate_vector(fftsize);
-    context->spec_pulse_i = allocate_vector(fftsize);
-    context->spec_noise_r = allocate_vector(fftsize);
-    context->spec_noise_i = allocate_vector(fftsize);
+    context->spec_pulse = REIM_ALLOC(numbins, complex_t);
+    context->spec_noise = REIM_ALLOC(numbins, complex_t);
+    context->spec_correction = REIM_ALLOC(SYNTHESIS_AP_NUMBINS, complex_t);
+    context->dct_ap = create_dct(SYNTHESIS_AP_FFTSIZE);
+    context->dst_ap = create_dst(SYNTHESIS_AP_FFTSIZE);
+    size_t scratch_length = get_vocoder_scratch_length(vocoder);
+    scratch_length = MAX(scratch_length, get_fft_scratch_length(context->dct_ap));
+    scratch_length = MAX(scratch_length, get_fft_scratch_length(context->dst_ap));
+    context->scratch = allocate_fft_scratch(scratch_length);
 
     // window to remove DC component
     context->window = allocate_vector(fftsize);
@@ -120,13 +408,39 @@ synthesis_context_t* create_synthesis_context(const vocoder_context_t* vocoder)
 
     context->impulse_pulse = allocate_vector(fftsize);
     context->impulse_noise = allocate_vector(fftsize);
-    context->temp_r = allocate_vector(fftsize);
-    context->temp_i = allocate_vector(fftsize);
+    context->impulse_base = allocate_vector(fftsize);
+    context->has_impulse_base = false;
+    context->tolerance = 0.0;
+    context->support_pulse.window = allocate_vector(fftsize);
+    context->support_noise.window = allocate_vector(fftsize);
+    context->temp = REIM_ALLOC(numbins, complex_t);
     for (size_t i = 0; i < fftsize; i++) {
         context->impulse_pulse[i] = 0.0;
         context->impulse_noise[i] = 0.0;
     }
 
+    // fractional delay filters (Blackman windowed sinc, unity DC gain) for the delays of [0, 1] samples
+    context->delay_bank = allocate_vector((SYNTHESIS_DELAY_PHASES + 1) * SYNTHESIS_DELAY_TAPS);
+    context->delay_filter = allocate_vector(SYNTHESIS_DELAY_TAPS);
+    for (size_t p = 0; p <= SYNTHESIS_DELAY_PHASES; p++) {
+        real_t* filter = context->delay_bank + p * SYNTHESIS_DELAY_TAPS;
+        const double delay = (double)p / SYNTHESIS_DELAY_PHASES;
+        const double half = SYNTHESIS_DELAY_TAPS / 2;
+        double sum = 0.0;
+        for (size_t k = 0; k < SYNTHESIS_DELAY_TAPS; k++) {
+            const double t = (double)k - (half - 1) - delay;
+            const double x = REIM_PI * t;
+            const double sinc = (t == 0.0) ? 1.0 : sin(x) / x;
+            const double w = REIM_PI * (t + half) / half;
+            const double window = (fabs(t) < half) ? 0.42 - 0.5 * cos(w) + 0.08 * cos(2 * w) : 0.0;
+            filter[k] = sinc * window;
+            sum += filter[k];
+        }
+        for (size_t k = 0; k < SYNTHESIS_DELAY_TAPS; k++) {
+            filter[k] /= sum;
+        }
+    }
+
     context->interval = fs / 300;
     context->pulse_int = 0;
     context->pulse_frc = 0.0;
@@ -136,26 +450,64 @@ synthesis_context_t* create_synthesis_context(const vocoder_context_t* vocoder)
     context->interval_random = 0;
     context->gain_noise = sqrt(context->interval_velvet);
     context->noise_int = 0;
+    context->has_impulse_noise = false;
+
+    // block mode: spectrum of the window to remove DC, and the waveform including the wrapped tails
+    context->noise_block = noise_block;
+    context->noise_length = (size_t)floor(vocoder->period / 1000.0 * fs);
+    context->noise_rendered = 0;
+    context->noise_pending = 0;
+    context->spec_window = NULL;
+    context->impulse_velvet = NULL;
+    if (noise_block) {
+        context->spec_window = REIM_ALLOC(numbins, complex_t);
+        context->impulse_velvet = allocate_vector(fftsize + fftsize / 4);
+        execute_rfft_with_scratch(vocoder->rfft, context->window, context->impulse_velvet, context->impulse_velvet + numbins, context->scratch);
+        for (size_t k = 0; k < numbins; k++) {
+            context->spec_window[k].re = context->impulse_velvet[k];
+            context->spec_window[k].im = context->impulse_velvet[numbins + k];
+        }
+    }
 
     const size_t period_max = (size_t)ceil(fs / fo_floor);
-    context->buffer = create_circular_queue(period_max + fftsize);
+    context->buffer = create_circular_queue(MAX(period_max, fftsize / 4) + fftsize);
 
     return context;
 }
 
+synthesis_context_t* create_synthesis_context(const vocoder_context_t* vocoder)
+{
+    return create_synthesis_context_with_mode(vocoder, false);
+}
+
+synthesis_context_t* create_synthesis_context_block_noise(const vocoder_context_t* vocoder)
+{
+    return create_synthesis_context_with_mode(vocoder, true);
+}
+
 void destroy_synthesis_context(synthesis_context_t** context)
 {
-    free_vector((*context)->spec_pulse_r);
-    free_vector((*context)->spec_pulse_i);
-    free_vector((*context)->spec_noise_r);
-    free_vector((*context)->spec_noise_i);
+    REIM_FREE((*context)->spec_pulse);
+    REIM_FREE((*context)->spec_noise);
+    REIM_FREE((*context)->spec_correction);
+    destroy_dct(&(*context)->dct_ap);
+    destroy_dst(&(*context)->dst_ap);
+    free_fft_scratch((*context)->scratch);
 
     free_vector((*context)->window);
 
     free_vector((*context)->impulse_pulse);
     free_vector((*context)->impulse_noise);
-    free_vector((*context)->temp_r);
-    free_vector((*context)->temp_i);
+    free_vector((*context)->impulse_base);
+    free_vector((*context)->support_pulse.window);
+    free_vector((*context)->support_noise.window);
+    free_vector((*context)->delay_bank);
+    free_vector((*context)->delay_filter);
+    REIM_FREE((*context)->temp);
+    if ((*context)->noise_block) {
+        REIM_FREE((*context)->spec_window);
+        free_vector((*context)->impulse_velvet);
+    }
 
     destroy_circular_queue(&(*context)->buffer);
 
@@ -163,60 +515,129 @@ void destroy_synthesis_context(synthesis_context_t** context)
     *context = NULL;
 }
 
-void synthesize_new_frame(vocoder_context_t* vocoder, synthesis_context_t* context, double fo, bool isvoiced, bool issilence, double* ap, double* sp)
+static void synthesize_new_frame_with_scale(vocoder_context_t* vocoder, synthesis_context_t* context,
+    double fo, bool isvoiced, bool issilence, const real_t* ap, const real_t* sp, bool logarithmic)
 {
     const double fs = vocoder->fs;
     const size_t fftsize = vocoder->fftsize;
     const size_t numbins = vocoder->numbins;
 
-    for (size_t k = 0; k < numbins; k++) {
-        const double spec = sp[k];
-        const double aper = ap[k] * ap[k];
-        context->spec_pulse_r[k] = spec * (1.0 - aper);
-        context->spec_noise_r[k] = spec * aper;
-    }
-    for (size_t k = 0; k < numbins - 2; k++) {
-        context->spec_pulse_r[numbins + k] = context->spec_pulse_r[numbins - 2 - k];
-        context->spec_noise_r[numbins + k] = context->spec_noise_r[numbins - 2 - k];
+    context->has_pulse = (isvoiced && !issilence);
+    context->has_noise = !issilence;
+
+    // minimum phase filter of the spectral envelope (shared by both components, the noise is needed when the pulse is)
+    if (context->has_noise) {
+        if (logarithmic) {
+            // the floor of the logarithm below: log(exp(x) + 1e-12) = x + log(1 + 1e-12 * exp(-x)),
+            // the correction is negligible (less than 1e-7) except for the bins close to the floor
+            const double threshold = log(1e-12) + 16.0;
+            for (size_t k = 0; k < numbins; k++) {
+                const double x = sp[k];
+                context->spec_noise[k].re = (x < threshold) ? x + log(1.0 + 1e-12 * exp(-x)) : x;
+            }
+        } else {
+            real_t* sp_floor = (real_t*)context->temp;
+            for (size_t k = 0; k < numbins; k++) {
+                sp_floor[k] = sp[k] + 1e-12;
+            }
+            vlog(sp_floor, sp_floor, numbins);
+            for (size_t k = 0; k < numbins; k++) {
+                context->spec_noise[k].re = sp_floor[k];
+            }
+        }
+        generate_minimum_phase_spectrum(context->spec_noise, fftsize, (real_t*)context->temp, vocoder->dct, vocoder->dst, context->scratch);
     }
 
+    // flat aperiodicity: the corrections are the gains
+    const bool is_flat = is_flat_aperiodicity(ap, numbins);
+    const double aper = ap[0] * ap[0];
+
     // periodic component
-    context->has_pulse = (isvoiced && !issilence);
     if (context->has_pulse) {
         context->interval = fs / fo;
         double gain_pulse = sqrt(context->interval);
 
         // create minimum phase filter
-        generate_minimum_phase_spectrum(context->spec_pulse_r, context->spec_pulse_i, gain_pulse, fftsize, vocoder->fft, vocoder->ifft);
+        if (is_flat) {
+            const double gain = gain_pulse * sqrt(1.0 - aper);
+            for (size_t k = 0; k < numbins; k++) {
+                context->spec_pulse[k].re = gain * context->spec_noise[k].re;
+                context->spec_pulse[k].im = gain * context->spec_noise[k].im;
+            }
+        } else {
+            generate_aperiodicity_correction(context->spec_correction, ap, true, gain_pulse,
+                numbins, context->dct_ap, context->dst_ap, context->scratch);
+            apply_aperiodicity_correction(context->spec_pulse, context->spec_noise, context->spec_correction, numbins);
+        }
+
+        // the impulse response is rendered at the first excitation in the frame
+        context->has_impulse_base = false;
     }
 
     // aperiodic component
-    context->has_noise = !issilence;
     if (context->has_noise) {
         double gain_noise = context->gain_noise;
 
         // create minimum phase filter
-        generate_minimum_phase_spectrum(context->spec_noise_r, context->spec_noise_i, gain_noise, fftsize, vocoder->fft, vocoder->ifft);
+        if (is_flat) {
+            const double gain = gain_noise * sqrt(aper);
+            for (size_t k = 0; k < numbins; k++) {
+                context->spec_noise[k].re *= gain;
+                context->spec_noise[k].im *= gain;
+            }
+        } else {
+            generate_aperiodicity_correction(context->spec_correction, ap, false, gain_noise,
+                numbins, context->dct_ap, context->dst_ap, context->scratch);
+            apply_aperiodicity_correction(context->spec_noise, context->spec_noise, context->spec_correction, numbins);
+        }
+
+        // the impulse response is rendered at the first excitation in the frame
+        context->has_impulse_noise = false;
 
-        // create impulse response for aperiodic component
-        generate_impulse(context->impulse_noise, context->spec_noise_r, context->spec_noise_i, 0.0,
-            context->window, context->temp_r, context->temp_i, fftsize, vocoder->ifft);
+        if (context->noise_block) {
+            context->noise_pending = context->noise_length;
+            render_velvet_noise(vocoder, context);
+        }
+    } else {
+        // the samples already rendered are still played (their random numbers are drawn)
+        context->noise_pending = 0;
     }
 }
 
-double synthesize_next_sample(vocoder_context_t* vocoder, synthesis_context_t* context)
+void synthesize_new_frame(vocoder_context_t* vocoder, synthesis_context_t* context, double fo, bool isvoiced, bool issilence, const real_t* ap, const real_t* sp)
+{
+    synthesize_new_frame_with_scale(vocoder, context, fo, isvoiced, issilence, ap, sp, false);
+}
+
+void synthesize_new_frame_log(vocoder_context_t* vocoder, synthesis_context_t* context, double fo, bool isvoiced, bool issilence, const real_t* ap, const real_t* sp_log)
+{
+    synthesize_new_frame_with_scale(vocoder, context, fo, isvoiced, issilence, ap, sp_log, true);
+}
+
+real_t synthesize_next_sample(vocoder_context_t* vocoder, synthesis_context_t* context)
 {
     const size_t fftsize = vocoder->fftsize;
 
     // periodic component
     if (context->has_pulse) {
         if (context->pulse_int == 0) {
-            // create impulse response for periodic component
-            generate_impulse(context->impulse_pulse, context->spec_pulse_r, context->spec_pulse_i, context->pulse_frc,
-                context->window, context->temp_r, context->temp_i, fftsize, vocoder->ifft);
+            // create impulse response for periodic component:
+            // the impulse response of the frame is delayed by the fractional part of the excitation position
+            // (truncated with the margin for the delay filter)
+            const impulse_support_t* support = &context->support_pulse;
+            if (!context->has_impulse_base) {
+                render_impulse(context->impulse_base, context->spec_pulse, context->temp, fftsize, vocoder->irfft, context->scratch);
+                set_impulse_support(&context->support_pulse, context->impulse_base, context->window,
+                    fftsize, context->tolerance, SYNTHESIS_DELAY_TAPS / 2);
+                context->has_impulse_base = true;
+            }
+            delay_impulse(context->impulse_pulse, context->impulse_base, context->pulse_frc,
+                context->delay_bank, context->delay_filter, fftsize, support);
+            remove_dc(context->impulse_pulse + support->offset, support->window, support->length);
 
             // write impulse
-            push_additive_circular_queue(context->buffer, context->impulse_pulse, fftsize);
+            push_additive_offset_circular_queue(context->buffer, support->offset,
+                context->impulse_pulse + support->offset, support->length);
 
             // update excitation position
             const double interval_int = floor(context->interval);
@@ -230,20 +651,71 @@ double synthesize_next_sample(vocoder_context_t* vocoder, synthesis_context_t* c
     }
 
     // aperiodic component
-    if (context->has_noise) {
-        if (context->noise_int == context->interval_random) {
+    // The block mode renders the rest of the frame beyond the span here, and the samples of the frame
+    // longer than noise_length go through the excitations as well as the other mode.
+    if (context->has_noise && context->noise_rendered == 0 && context->noise_pending > 0) {
+        render_velvet_noise(vocoder, context);
+    }
+    if (context->noise_rendered > 0) {
+        context->noise_rendered--;
+    } else if (context->has_noise) {
+        if (next_velvet_noise(context)) {
+            // create impulse response for aperiodic component
+            const impulse_support_t* support = &context->support_noise;
+            if (!context->has_impulse_noise) {
+                render_impulse(context->impulse_noise, context->spec_noise, context->temp, fftsize, vocoder->irfft, context->scratch);
+                set_impulse_support(&context->support_noise, context->impulse_noise, context->window,
+                    fftsize, context->tolerance, 0);
+                remove_dc(context->impulse_noise + support->offset, support->window, support->length);
+                context->has_impulse_noise = true;
+            }
+
             // write impulse
-            push_additive_circular_queue(context->buffer, context->impulse_noise, fftsize);
-        }
-        if (context->noise_int == context->interval_velvet - 1) {
-            // update excitation position
-            const double r = generate_uniform_random(context->random);
-            context->interval_random = (size_t)floor(r * (context->interval_velvet - 1));
-            context->noise_int = 0;
+            push_additive_offset_circular_queue(context->buffer, support->offset,
+                context->impulse_noise + support->offset, support->length);
         }
-        context->noise_int++;
     }
 
     // get from circular queue
     return pop_circular_queue(context->buffer);
 }
+
+void synthesize_block(vocoder_context_t* vocoder, synthesis_context_t* context, real_t* output, size_t length)
+{
+    size_t position = 0;
+    while (position < length) {
+        // samples until the next event (excitation or update of the velvet noise)
+        size_t count = length - position;
+        if (context->has_pulse) {
+            count = MIN(count, (size_t)MAX(context->pulse_int, 0));
+        }
+        if (context->noise_rendered > 0) {
+            count = MIN(count, context->noise_rendered);
+        } else if (context->has_noise && context->noise_pending > 0) {
+            count = 0;
+        } else if (context->has_noise) {
+            const size_t noise_next = (context->noise_int <= context->interval_random)
+                ? context->interval_random
+                : context->interval_velvet - 1;
+            count = MIN(count, (noise_next > context->noise_int) ? noise_next - context->noise_int : 0);
+        }
+
+        // no event: just get from circular queue (zeros when it's empty)
+        if (context->has_pulse) {
+            context->pulse_int -= (int32_t)count;
+        }
+        if (context->noise_rendered > 0) {
+            context->noise_rendered -= count;
+        } else if (context->has_noise) {
+            context->noise_int += count;
+        }
+        pop_block_circular_queue(context->buffer, output + position, count);
+        position += count;
+
+        // event
+        if (position < length) {
+            output[position] = synthesize_next_sample(vocoder, context);
+            position++;
+        }
+    }
+}
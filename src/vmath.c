@@ -0,0 +1,450 @@
+// Vector math: polynomial approximations with the range reductions, one kernel per instruction set
+// The instruction set is selected at runtime (cpu.h).
+#include "reim/vmath.h"
+
+#include "reim/cpu.h"
+#include "reim/mathematics.h"
+#include <float.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VMATH_X86
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define VMATH_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define VMATH_TARGET(isa) __attribute__((target(isa)))
+#else
+#define VMATH_TARGET(isa)
+#endif
+
+typedef struct {
+    const char* name;
+    void (*log)(const real_t* x, real_t* y, size_t n);
+    void (*exp)(const real_t* x, real_t* y, size_t n);
+    void (*sincos)(const real_t* x, real_t* s, real_t* c, size_t n);
+    void (*atan2)(const real_t* y, const real_t* x, real_t* angle, size_t n);
+    void (*abs2)(const complex_t* x, real_t* y, size_t n);
+} vmath_kernel_t;
+
+// Constants of the precision
+//   ROUND_MAGIC: x + ROUND_MAGIC - ROUND_MAGIC rounds x to the integer (the lowest bits of x + ROUND_MAGIC hold it)
+//   POW2_MAGIC: 2^(mantissa bits), the integer below it is in the mantissa of POW2_MAGIC + integer
+//   LN2_HI, PIO2_1 and PIO2_2 have the zeros in the lowest bits, so the products with the integer are exact.
+#ifdef REIM_USE_FLOAT
+typedef uint32_t vmath_uint_t;
+#define VMATH_SIGN_SHIFT 31
+#define VMATH_MANTISSA_BITS 23
+#define VMATH_EXPONENT_BIAS 127.0f
+#define VMATH_MANTISSA_MASK 0x007FFFFFu
+#define VMATH_ABS_MASK 0x7FFFFFFFu
+#define VMATH_SIGN_MASK 0x80000000u
+#define VMATH_ROUND_MAGIC 12582912.0f // 1.5 * 2^23
+#define VMATH_POW2_MAGIC 8388608.0f   // 2^23
+#define VMATH_REAL_MIN FLT_MIN
+#define VMATH_EXP_MIN -87.0f
+#define VMATH_EXP_MAX 88.0f
+#define VMATH_PIO2_1 1.5703125f
+#define VMATH_PIO2_2 4.837512969970703125e-4f
+#define VMATH_PIO2_3 7.54978995489188216e-8f
+#define VMATH_LOG_TERMS 6
+#define VMATH_EXP_TERMS 8
+#define VMATH_SIN_TERMS 4
+#define VMATH_COS_TERMS 4
+#define VMATH_ATAN_TERMS 6
+#else
+typedef uint64_t vmath_uint_t;
+#define VMATH_SIGN_SHIFT 63
+#define VMATH_MANTISSA_BITS 52
+#define VMATH_EXPONENT_BIAS 1023.0
+#define VMATH_MANTISSA_MASK 0x000FFFFFFFFFFFFFull
+#define VMATH_ABS_MASK 0x7FFFFFFFFFFFFFFFull
+#define VMATH_SIGN_MASK 0x8000000000000000ull
+#define VMATH_ROUND_MAGIC 6755399441055744.0 // 1.5 * 2^52
+#define VMATH_POW2_MAGIC 4503599627370496.0  // 2^52
+#define VMATH_REAL_MIN DBL_MIN
+#define VMATH_EXP_MIN -708.0
+#define VMATH_EXP_MAX 709.0
+#define VMATH_PIO2_1 1.57079632673412561417e+00
+#define VMATH_PIO2_2 6.07710050630396597660e-11
+#define VMATH_PIO2_3 2.02226624871116645580e-21
+#define VMATH_LOG_TERMS 12
+#define VMATH_EXP_TERMS 13
+#define VMATH_SIN_TERMS 8
+#define VMATH_COS_TERMS 8
+#define VMATH_ATAN_TERMS 13
+#endif
+#define VMATH_LN2_HI 0.693359375
+#define VMATH_LN2_LO -2.12194440054690583e-4
+#define VMATH_LOG2E 1.44269504088896340736
+#define VMATH_SQRT2 1.41421356237309504880
+#define VMATH_2_PI 0.63661977236758134308
+#define VMATH_PI_HI 3.14159265358979311600
+#define VMATH_PI_LO 1.22464679914735317723e-16
+#define VMATH_PIO2_HI 1.57079632679489655800
+#define VMATH_PIO2_LO 6.12323399573676588613e-17
+
+// Taylor series (the remainders are below the precision within the reduced ranges)
+
+// log(m) = 2 s (1 + s^2 / 3 + s^4 / 5 + ...) (|s| <= 0.172)
+static const real_t vmath_log_coefs[] = { 1.0, 1.0 / 3, 1.0 / 5, 1.0 / 7, 1.0 / 9, 1.0 / 11,
+#ifndef REIM_USE_FLOAT
+    1.0 / 13, 1.0 / 15, 1.0 / 17, 1.0 / 19, 1.0 / 21, 1.0 / 23
+#endif
+};
+
+// exp(r) = 1 + r + r^2 / 2! + ... (|r| <= 0.347)
+static const real_t vmath_exp_coefs[] = { 1.0, 1.0, 1.0 / 2, 1.0 / 6, 1.0 / 24, 1.0 / 120, 1.0 / 720, 1.0 / 5040,
+#ifndef REIM_USE_FLOAT
+    1.0 / 40320, 1.0 / 362880, 1.0 / 3628800, 1.0 / 39916800, 1.0 / 479001600
+#endif
+};
+
+// sin(r) = r + r^3 (-1 / 3! + r^2 / 5! - ...), cos(r) = 1 - r^2 / 2 + r^4 (1 / 4! - r^2 / 6! + ...) (|r| <= pi / 4)
+static const real_t vmath_sin_coefs[] = { -1.0 / 6, 1.0 / 120, -1.0 / 5040, 1.0 / 362880,
+#ifndef REIM_USE_FLOAT
+    -1.0 / 39916800, 1.0 / 6227020800, -1.0 / 1307674368000, 1.0 / 355687428096000
+#endif
+};
+static const real_t vmath_cos_coefs[] = { 1.0 / 24, -1.0 / 720, 1.0 / 40320, -1.0 / 3628800,
+#ifndef REIM_USE_FLOAT
+    1.0 / 479001600, -1.0 / 87178291200, 1.0 / 20922789888000, -1.0 / 6402373705728000
+#endif
+};
+
+// atan(t) = t (1 - t^2 / 3 + t^4 / 5 - ...) (|t| <= tan(pi / 16))
+static const real_t vmath_atan_coefs[] = { 1.0, -1.0 / 3, 1.0 / 5, -1.0 / 7, 1.0 / 9, -1.0 / 11,
+#ifndef REIM_USE_FLOAT
+    1.0 / 13, -1.0 / 15, 1.0 / 17, -1.0 / 19, 1.0 / 21, -1.0 / 23, 1.0 / 25
+#endif
+};
+
+// Scalar (the reference of the SIMD kernels)
+static inline vmath_uint_t get_bits(real_t x)
+{
+    vmath_uint_t i;
+    memcpy(&i, &x, sizeof(i));
+    return i;
+}
+
+static inline real_t from_bits(vmath_uint_t i)
+{
+    real_t x;
+    memcpy(&x, &i, sizeof(x));
+    return x;
+}
+
+#define KERNEL(name) name##_scalar
+#define KERNEL_NAME "scalar"
+#define KERNEL_TARGET
+#define VREAL real_t
+#define VLEN 1
+#define VINT vmath_uint_t
+#define VLOAD(p) (*(p))
+#define VSTORE(p, v) (*(p) = (v))
+#define VSET1(x) ((real_t)(x))
+#define VADD(a, b) ((a) + (b))
+#define VSUB(a, b) ((a) - (b))
+#define VMUL(a, b) ((a) * (b))
+#define VDIV(a, b) ((a) / (b))
+#define VSQRT(a) sqrt(a)
+#define VMIN(a, b) MIN(a, b)
+#define VMAX(a, b) MAX(a, b)
+#define VMADD(a, b, c) ((a) * (b) + (c))
+#define VBITS(v) get_bits(v)
+#define VFROM_BITS(i) from_bits(i)
+#define VISET1(x) ((vmath_uint_t)(x))
+#define VIAND(a, b) ((a) & (b))
+#define VIOR(a, b) ((a) | (b))
+#define VIXOR(a, b) ((a) ^ (b))
+#define VIADD(a, b) ((a) + (b))
+#define VISUB(a, b) ((a) - (b))
+#define VISHL(i, n) ((i) << (n))
+#define VISHR(i, n) ((i) >> (n))
+#include "vmath_kernel.h"
+
+#ifdef VMATH_X86
+
+// SSE2
+#define KERNEL(name) name##_sse2
+#define KERNEL_NAME "SSE2"
+#define KERNEL_TARGET VMATH_TARGET("sse2")
+#define VINT __m128i
+#define VIAND(a, b) _mm_and_si128(a, b)
+#define VIOR(a, b) _mm_or_si128(a, b)
+#define VIXOR(a, b) _mm_xor_si128(a, b)
+#ifdef REIM_USE_FLOAT
+#define VREAL __m128
+#define VLEN 4
+#define VLOAD(p) _mm_loadu_ps(p)
+#define VSTORE(p, v) _mm_storeu_ps(p, v)
+#define VSET1(x) _mm_set1_ps(x)
+#define VADD(a, b) _mm_add_ps(a, b)
+#define VSUB(a, b) _mm_sub_ps(a, b)
+#define VMUL(a, b) _mm_mul_ps(a, b)
+#define VDIV(a, b) _mm_div_ps(a, b)
+#define VSQRT(a) _mm_sqrt_ps(a)
+#define VMIN(a, b) _mm_min_ps(a, b)
+#define VMAX(a, b) _mm_max_ps(a, b)
+#define VMADD(a, b, c) _mm_add_ps(_mm_mul_ps(a, b), c)
+#define VBITS(v) _mm_castps_si128(v)
+#define VFROM_BITS(i) _mm_castsi128_ps(i)
+#define VISET1(x) _mm_set1_epi32((int)(x))
+#define VIADD(a, b) _mm_add_epi32(a, b)
+#define VISUB(a, b) _mm_sub_epi32(a, b)
+#define VISHL(i, n) _mm_slli_epi32(i, n)
+#define VISHR(i, n) _mm_srli_epi32(i, n)
+#define VHADD(a, b) _mm_add_ps(_mm_shuffle_ps(a, b, 0x88), _mm_shuffle_ps(a, b, 0xDD))
+#else
+#define VREAL __m128d
+#define VLEN 2
+#define VLOAD(p) _mm_loadu_pd(p)
+#define VSTORE(p, v) _mm_storeu_pd(p, v)
+#define VSET1(x) _mm_set1_pd(x)
+#define VADD(a, b) _mm_add_pd(a, b)
+#define VSUB(a, b) _mm_sub_pd(a, b)
+#define VMUL(a, b) _mm_mul_pd(a, b)
+#define VDIV(a, b) _mm_div_pd(a, b)
+#define VSQRT(a) _mm_sqrt_pd(a)
+#define VMIN(a, b) _mm_min_pd(a, b)
+#define VMAX(a, b) _mm_max_pd(a, b)
+#define VMADD(a, b, c) _mm_add_pd(_mm_mul_pd(a, b), c)
+#define VBITS(v) _mm_castpd_si128(v)
+#define VFROM_BITS(i) _mm_castsi128_pd(i)
+#define VISET1(x) _mm_set1_epi64x((long long)(x))
+#define VIADD(a, b) _mm_add_epi64(a, b)
+#define VISUB(a, b) _mm_sub_epi64(a, b)
+#define VISHL(i, n) _mm_slli_epi64(i, n)
+#define VISHR(i, n) _mm_srli_epi64(i, n)
+#define VHADD(a, b) _mm_add_pd(_mm_unpacklo_pd(a, b), _mm_unpackhi_pd(a, b))
+#endif
+#include "vmath_kernel.h"
+
+// AVX2 and FMA
+#define KERNEL(name) name##_avx2
+#define KERNEL_NAME "AVX2"
+#define KERNEL_TARGET VMATH_TARGET("avx2,fma")
+#define VINT __m256i
+#define VIAND(a, b) _mm256_and_si256(a, b)
+#define VIOR(a, b) _mm256_or_si256(a, b)
+#define VIXOR(a, b) _mm256_xor_si256(a, b)
+#ifdef REIM_USE_FLOAT
+#define VREAL __m256
+#define VLEN 8
+#define VLOAD(p) _mm256_loadu_ps(p)
+#define VSTORE(p, v) _mm256_storeu_ps(p, v)
+#define VSET1(x) _mm256_set1_ps(x)
+#define VADD(a, b) _mm256_add_ps(a, b)
+#define VSUB(a, b) _mm256_sub_ps(a, b)
+#define VMUL(a, b) _mm256_mul_ps(a, b)
+#define VDIV(a, b) _mm256_div_ps(a, b)
+#define VSQRT(a) _mm256_sqrt_ps(a)
+#define VMIN(a, b) _mm256_min_ps(a, b)
+#define VMAX(a, b) _mm256_max_ps(a, b)
+#define VMADD(a, b, c) _mm256_fmadd_ps(a, b, c)
+#define VBITS(v) _mm256_castps_si256(v)
+#define VFROM_BITS(i) _mm256_castsi256_ps(i)
+#define VISET1(x) _mm256_set1_epi32((int)(x))
+#define VIADD(a, b) _mm256_add_epi32(a, b)
+#define VISUB(a, b) _mm256_sub_epi32(a, b)
+#define VISHL(i, n) _mm256_slli_epi32(i, n)
+#define VISHR(i, n) _mm256_srli_epi32(i, n)
+#define VHADD(a, b) _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_hadd_ps(a, b)), 0xD8))
+#else
+#define VREAL __m256d
+#define VLEN 4
+#define VLOAD(p) _mm256_loadu_pd(p)
+#define VSTORE(p, v) _mm256_storeu_pd(p, v)
+#define VSET1(x) _mm256_set1_pd(x)
+#define VADD(a, b) _mm256_add_pd(a, b)
+#define VSUB(a, b) _mm256_sub_pd(a, b)
+#define VMUL(a, b) _mm256_mul_pd(a, b)
+#define VDIV(a, b) _mm256_div_pd(a, b)
+#define VSQRT(a) _mm256_sqrt_pd(a)
+#define VMIN(a, b) _mm256_min_pd(a, b)
+#define VMAX(a, b) _mm256_max_pd(a, b)
+#define VMADD(a, b, c) _mm256_fmadd_pd(a, b, c)
+#define VBITS(v) _mm256_castpd_si256(v)
+#define VFROM_BITS(i) _mm256_castsi256_pd(i)
+#define VISET1(x) _mm256_set1_epi64x((long long)(x))
+#define VIADD(a, b) _mm256_add_epi64(a, b)
+#define VISUB(a, b) _mm256_sub_epi64(a, b)
+#define VISHL(i, n) _mm256_slli_epi64(i, n)
+#define VISHR(i, n) _mm256_srli_epi64(i, n)
+#define VHADD(a, b) _mm256_permute4x64_pd(_mm256_hadd_pd(a, b), 0xD8)
+#endif
+#include "vmath_kernel.h"
+
+// AVX-512
+#define KERNEL(name) name##_avx512
+#define KERNEL_NAME "AVX-512"
+#define KERNEL_TARGET VMATH_TARGET("avx512f")
+#define VINT __m512i
+#define VIAND(a, b) _mm512_and_si512(a, b)
+#define VIOR(a, b) _mm512_or_si512(a, b)
+#define VIXOR(a, b) _mm512_xor_si512(a, b)
+#ifdef REIM_USE_FLOAT
+#define VREAL __m512
+#define VLEN 16
+#define VLOAD(p) _mm512_loadu_ps(p)
+#define VSTORE(p, v) _mm512_storeu_ps(p, v)
+#define VSET1(x) _mm512_set1_ps(x)
+#define VADD(a, b) _mm512_add_ps(a, b)
+#define VSUB(a, b) _mm512_sub_ps(a, b)
+#define VMUL(a, b) _mm512_mul_ps(a, b)
+#define VDIV(a, b) _mm512_div_ps(a, b)
+#define VSQRT(a) _mm512_sqrt_ps(a)
+#define VMIN(a, b) _mm512_min_ps(a, b)
+#define VMAX(a, b) _mm512_max_ps(a, b)
+#define VMADD(a, b, c) _mm512_fmadd_ps(a, b, c)
+#define VBITS(v) _mm512_castps_si512(v)
+#define VFROM_BITS(i) _mm512_castsi512_ps(i)
+#define VISET1(x) _mm512_set1_epi32((int)(x))
+#define VIADD(a, b) _mm512_add_epi32(a, b)
+#define VISUB(a, b) _mm512_sub_epi32(a, b)
+#define VISHL(i, n) _mm512_slli_epi32(i, n)
+#define VISHR(i, n) _mm512_srli_epi32(i, n)
+#define VHADD(a, b) _mm512_add_ps(                                                                                  \
+    _mm512_permutex2var_ps(a, _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30), b), \
+    _mm512_permutex2var_ps(a, _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31), b))
+#else
+#define VREAL __m512d
+#define VLEN 8
+#define VLOAD(p) _mm512_loadu_pd(p)
+#define VSTORE(p, v) _mm512_storeu_pd(p, v)
+#define VSET1(x) _mm512_set1_pd(x)
+#define VADD(a, b) _mm512_add_pd(a, b)
+#define VSUB(a, b) _mm512_sub_pd(a, b)
+#define VMUL(a, b) _mm512_mul_pd(a, b)
+#define VDIV(a, b) _mm512_div_pd(a, b)
+#define VSQRT(a) _mm512_sqrt_pd(a)
+#define VMIN(a, b) _mm512_min_pd(a, b)
+#define VMAX(a, b) _mm512_max_pd(a, b)
+#define VMADD(a, b, c) _mm512_fmadd_pd(a, b, c)
+#define VBITS(v) _mm512_castpd_si512(v)
+#define VFROM_BITS(i) _mm512_castsi512_pd(i)
+#define VISET1(x) _mm512_set1_epi64((long long)(x))
+#define VIADD(a, b) _mm512_add_epi64(a, b)
+#define VISUB(a, b) _mm512_sub_epi64(a, b)
+#define VISHL(i, n) _mm512_slli_epi64(i, n)
+#define VISHR(i, n) _mm512_srli_epi64(i, n)
+#define VHADD(a, b) _mm512_add_pd(                                                \
+    _mm512_permutex2var_pd(a, _mm512_setr_epi64(0, 2, 4, 6, 8, 10, 12, 14), b), \
+    _mm512_permutex2var_pd(a, _mm512_setr_epi64(1, 3, 5, 7, 9, 11, 13, 15), b))
+#endif
+#include "vmath_kernel.h"
+
+#elif defined VMATH_NEON
+
+// NEON (AArch64)
+#define KERNEL(name) name##_neon
+#define KERNEL_NAME "NEON"
+#define KERNEL_TARGET
+#ifdef REIM_USE_FLOAT
+#define VREAL float32x4_t
+#define VLEN 4
+#define VINT uint32x4_t
+#define VLOAD(p) vld1q_f32(p)
+#define VSTORE(p, v) vst1q_f32(p, v)
+#define VSET1(x) vdupq_n_f32(x)
+#define VADD(a, b) vaddq_f32(a, b)
+#define VSUB(a, b) vsubq_f32(a, b)
+#define VMUL(a, b) vmulq_f32(a, b)
+#define VDIV(a, b) vdivq_f32(a, b)
+#define VSQRT(a) vsqrtq_f32(a)
+#define VMIN(a, b) vminq_f32(a, b)
+#define VMAX(a, b) vmaxq_f32(a, b)
+#define VMADD(a, b, c) vfmaq_f32(c, a, b)
+#define VBITS(v) vreinterpretq_u32_f32(v)
+#define VFROM_BITS(i) vreinterpretq_f32_u32(i)
+#define VISET1(x) vdupq_n_u32((uint32_t)(x))
+#define VIAND(a, b) vandq_u32(a, b)
+#define VIOR(a, b) vorrq_u32(a, b)
+#define VIXOR(a, b) veorq_u32(a, b)
+#define VIADD(a, b) vaddq_u32(a, b)
+#define VISUB(a, b) vsubq_u32(a, b)
+#define VISHL(i, n) vshlq_n_u32(i, n)
+#define VISHR(i, n) vshrq_n_u32(i, n)
+#define VHADD(a, b) vpaddq_f32(a, b)
+#else
+#define VREAL float64x2_t
+#define VLEN 2
+#define VINT uint64x2_t
+#define VLOAD(p) vld1q_f64(p)
+#define VSTORE(p, v) vst1q_f64(p, v)
+#define VSET1(x) vdupq_n_f64(x)
+#define VADD(a, b) vaddq_f64(a, b)
+#define VSUB(a, b) vsubq_f64(a, b)
+#define VMUL(a, b) vmulq_f64(a, b)
+#define VDIV(a, b) vdivq_f64(a, b)
+#define VSQRT(a) vsqrtq_f64(a)
+#define VMIN(a, b) vminq_f64(a, b)
+#define VMAX(a, b) vmaxq_f64(a, b)
+#define VMADD(a, b, c) vfmaq_f64(c, a, b)
+#define VBITS(v) vreinterpretq_u64_f64(v)
+#define VFROM_BITS(i) vreinterpretq_f64_u64(i)
+#define VISET1(x) vdupq_n_u64((uint64_t)(x))
+#define VIAND(a, b) vandq_u64(a, b)
+#define VIOR(a, b) vorrq_u64(a, b)
+#define VIXOR(a, b) veorq_u64(a, b)
+#define VIADD(a, b) vaddq_u64(a, b)
+#define VISUB(a, b) vsubq_u64(a, b)
+#define VISHL(i, n) vshlq_n_u64(i, n)
+#define VISHR(i, n) vshrq_n_u64(i, n)
+#define VHADD(a, b) vpaddq_f64(a, b)
+#endif
+#include "vmath_kernel.h"
+
+#endif
+
+// Kernels indexed by the instruction set (NULL: not built for the target)
+static const vmath_kernel_t* const vmath_kernels[CPU_ISA_COUNT] = {
+    [CPU_ISA_SCALAR] = &kernel_scalar,
+#ifdef VMATH_X86
+    [CPU_ISA_SSE2] = &kernel_sse2,
+    [CPU_ISA_AVX2] = &kernel_avx2,
+    [CPU_ISA_AVX512] = &kernel_avx512,
+#elif defined VMATH_NEON
+    [CPU_ISA_NEON] = &kernel_neon,
+#endif
+};
+
+static const vmath_kernel_t* get_vmath_kernel()
+{
+    const vmath_kernel_t* kernel = vmath_kernels[get_kernel_isa()];
+    return (kernel != NULL) ? kernel : &kernel_scalar;
+}
+
+const char* get_vmath_kernel_name()
+{
+    return get_vmath_kernel()->name;
+}
+
+void vlog(const real_t* x, real_t* y, size_t n)
+{
+    get_vmath_kernel()->log(x, y, n);
+}
+
+void vexp(const real_t* x, real_t* y, size_t n)
+{
+    get_vmath_kernel()->exp(x, y, n);
+}
+
+void vsincos(const real_t* x, real_t* s, real_t* c, size_t n)
+{
+    get_vmath_kernel()->sincos(x, s, c, n);
+}
+
+void vatan2(const real_t* y, const real_t* x, real_t* angle, size_t n)
+{
+    get_vmath_kernel()->atan2(y, x, angle, n);
+}
+
+void vabs2(const complex_t* x, real_t* y, size_t n)
+{
+    get_vmath_kernel()->abs2(x, y, n);
+}
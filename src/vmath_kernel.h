@@ -0,0 +1,239 @@
+// Vector math of one instruction set (included by vmath.c)
+//
+// The including file defines:
+//   KERNEL(name)      name with the suffix of the instruction set
+//   KERNEL_NAME       name reported by get_vmath_kernel_name()
+//   KERNEL_TARGET     attributes to enable the instruction set
+//   VREAL, VLEN       vector of VLEN real values
+//   VINT              vector of the unsigned integers of the same width (the bits of VREAL)
+//   VLOAD(p), VSTORE(p, v), VSET1(x)
+//   VADD(a, b), VSUB(a, b), VMUL(a, b), VDIV(a, b), VSQRT(a), VMIN(a, b), VMAX(a, b)
+//   VMADD(a, b, c)    a * b + c
+//   VBITS(v)          VREAL -> VINT (reinterpreted)
+//   VFROM_BITS(i)     VINT -> VREAL (reinterpreted)
+//   VISET1(x), VIAND(a, b), VIOR(a, b), VIXOR(a, b), VIADD(a, b), VISUB(a, b)
+//   VISHL(i, n), VISHR(i, n)  logical shifts by the constant
+//   VHADD(a, b)       (a0 + a1, a2 + a3, ..., b0 + b1, b2 + b3, ...) (optional, for vabs2)
+
+// all ones if the sign bit is set
+KERNEL_TARGET static inline VINT KERNEL(sign_mask)(VREAL v)
+{
+    return VISUB(VISET1(0), VISHR(VBITS(v), VMATH_SIGN_SHIFT));
+}
+
+// mask ? a : b
+KERNEL_TARGET static inline VREAL KERNEL(select)(VINT mask, VREAL a, VREAL b)
+{
+    const VINT bb = VBITS(b);
+    return VFROM_BITS(VIOR(VIAND(mask, VBITS(a)), VIXOR(bb, VIAND(mask, bb))));
+}
+
+KERNEL_TARGET static inline VREAL KERNEL(polynomial)(VREAL z, const real_t* coefs, size_t count)
+{
+    VREAL p = VSET1(coefs[count - 1]);
+    for (size_t i = count - 1; i > 0; i--) {
+        p = VMADD(p, z, VSET1(coefs[i - 1]));
+    }
+    return p;
+}
+
+// log(x) = e log(2) + log(m) (m in [sqrt(1/2), sqrt(2)]), log(m) = 2 atanh(s) (s = (m - 1) / (m + 1))
+KERNEL_TARGET static inline VREAL KERNEL(log1)(VREAL x)
+{
+    const VINT bits = VBITS(x);
+    const VREAL magic = VSET1(VMATH_POW2_MAGIC);
+    VREAL e = VSUB(VFROM_BITS(VIOR(VISHR(bits, VMATH_MANTISSA_BITS), VBITS(magic))), VSET1(VMATH_POW2_MAGIC + VMATH_EXPONENT_BIAS));
+    VREAL m = VFROM_BITS(VIOR(VIAND(bits, VISET1(VMATH_MANTISSA_MASK)), VBITS(VSET1(1.0))));
+    const VINT large = KERNEL(sign_mask)(VSUB(VSET1(VMATH_SQRT2), m));
+    m = KERNEL(select)(large, VMUL(m, VSET1(0.5)), m);
+    e = KERNEL(select)(large, VADD(e, VSET1(1.0)), e);
+
+    const VREAL f = VSUB(m, VSET1(1.0));
+    const VREAL s = VDIV(f, VADD(f, VSET1(2.0)));
+    const VREAL p = KERNEL(polynomial)(VMUL(s, s), vmath_log_coefs, VMATH_LOG_TERMS);
+    return VMADD(e, VSET1(VMATH_LN2_HI), VMADD(e, VSET1(VMATH_LN2_LO), VMUL(VADD(s, s), p)));
+}
+
+// exp(x) = 2^n exp(r) (|r| <= log(2) / 2)
+KERNEL_TARGET static inline VREAL KERNEL(exp1)(VREAL x)
+{
+    x = VMIN(VMAX(x, VSET1(VMATH_EXP_MIN)), VSET1(VMATH_EXP_MAX));
+    const VREAL magic = VSET1(VMATH_ROUND_MAGIC);
+    const VREAL n = VSUB(VMADD(x, VSET1(VMATH_LOG2E), magic), magic);
+    VREAL r = VMADD(n, VSET1(-VMATH_LN2_HI), x);
+    r = VMADD(n, VSET1(-VMATH_LN2_LO), r);
+    const VREAL p = KERNEL(polynomial)(r, vmath_exp_coefs, VMATH_EXP_TERMS);
+
+    // the biased exponent in the mantissa of n + bias + 2^(mantissa bits), shifted into the exponent field
+    const VREAL biased = VADD(n, VSET1(VMATH_POW2_MAGIC + VMATH_EXPONENT_BIAS));
+    return VMUL(p, VFROM_BITS(VISHL(VBITS(biased), VMATH_MANTISSA_BITS)));
+}
+
+// sin(x) and cos(x) from r = x - j pi / 2 (|r| <= pi / 4) and the quadrant j mod 4
+KERNEL_TARGET static inline void KERNEL(sincos1)(VREAL x, VREAL* s, VREAL* c)
+{
+    const VREAL magic = VSET1(VMATH_ROUND_MAGIC);
+    const VREAL t = VMADD(x, VSET1(VMATH_2_PI), magic);
+    const VREAL j = VSUB(t, magic);
+    const VINT quadrant = VBITS(t); // the lowest bits are j
+    VREAL r = VMADD(j, VSET1(-VMATH_PIO2_1), x);
+    r = VMADD(j, VSET1(-VMATH_PIO2_2), r);
+    r = VMADD(j, VSET1(-VMATH_PIO2_3), r);
+
+    const VREAL z = VMUL(r, r);
+    const VREAL sin_r = VMADD(VMUL(r, z), KERNEL(polynomial)(z, vmath_sin_coefs, VMATH_SIN_TERMS), r);
+    const VREAL cos_r = VMADD(VMUL(z, z), KERNEL(polynomial)(z, vmath_cos_coefs, VMATH_COS_TERMS), VMADD(z, VSET1(-0.5), VSET1(1.0)));
+
+    // odd quadrants swap sin and cos, and the signs follow the bit 1 of j (sin) and j + 1 (cos)
+    const VINT one = VISET1(1), two = VISET1(2);
+    const VINT swap = VISUB(VISET1(0), VIAND(quadrant, one));
+    const VINT sign_s = VISHL(VIAND(quadrant, two), VMATH_SIGN_SHIFT - 1);
+    const VINT sign_c = VISHL(VIAND(VIADD(quadrant, one), two), VMATH_SIGN_SHIFT - 1);
+    *s = VFROM_BITS(VIXOR(VBITS(KERNEL(select)(swap, cos_r, sin_r)), sign_s));
+    *c = VFROM_BITS(VIXOR(VBITS(KERNEL(select)(swap, sin_r, cos_r)), sign_c));
+}
+
+// atan(t) of t = min(|x|, |y|) / max(|x|, |y|) (halved twice: atan(t) = 2 atan(t / (1 + sqrt(1 + t^2)))), then the octant
+KERNEL_TARGET static inline VREAL KERNEL(atan21)(VREAL y, VREAL x)
+{
+    const VINT abs_mask = VISET1(VMATH_ABS_MASK);
+    const VREAL ax = VFROM_BITS(VIAND(VBITS(x), abs_mask));
+    const VREAL ay = VFROM_BITS(VIAND(VBITS(y), abs_mask));
+    const VREAL one = VSET1(1.0);
+    VREAL t = VDIV(VMIN(ax, ay), VMAX(VMAX(ax, ay), VSET1(VMATH_REAL_MIN)));
+    t = VDIV(t, VADD(one, VSQRT(VMADD(t, t, one))));
+    t = VDIV(t, VADD(one, VSQRT(VMADD(t, t, one))));
+    const VREAL p = KERNEL(polynomial)(VMUL(t, t), vmath_atan_coefs, VMATH_ATAN_TERMS);
+    VREAL a = VMUL(VMUL(t, p), VSET1(4.0));
+
+    a = KERNEL(select)(KERNEL(sign_mask)(VSUB(ax, ay)), VADD(VSUB(VSET1(VMATH_PIO2_HI), a), VSET1(VMATH_PIO2_LO)), a);
+    a = KERNEL(select)(KERNEL(sign_mask)(x), VADD(VSUB(VSET1(VMATH_PI_HI), a), VSET1(VMATH_PI_LO)), a);
+    return VFROM_BITS(VIOR(VBITS(a), VIAND(VBITS(y), VISET1(VMATH_SIGN_MASK))));
+}
+
+// The last elements go through a buffer of the vector length (the padding is 1).
+
+KERNEL_TARGET static void KERNEL(vlog)(const real_t* x, real_t* y, size_t n)
+{
+    size_t i = 0;
+    for (; i + VLEN <= n; i += VLEN) {
+        VSTORE(y + i, KERNEL(log1)(VLOAD(x + i)));
+    }
+    if (i < n) {
+        real_t buffer[VLEN];
+        for (size_t k = 0; k < VLEN; k++) {
+            buffer[k] = (i + k < n) ? x[i + k] : 1.0;
+        }
+        VSTORE(buffer, KERNEL(log1)(VLOAD(buffer)));
+        for (size_t k = 0; i + k < n; k++) {
+            y[i + k] = buffer[k];
+        }
+    }
+}
+
+KERNEL_TARGET static void KERNEL(vexp)(const real_t* x, real_t* y, size_t n)
+{
+    size_t i = 0;
+    for (; i + VLEN <= n; i += VLEN) {
+        VSTORE(y + i, KERNEL(exp1)(VLOAD(x + i)));
+    }
+    if (i < n) {
+        real_t buffer[VLEN];
+        for (size_t k = 0; k < VLEN; k++) {
+            buffer[k] = (i + k < n) ? x[i + k] : 1.0;
+        }
+        VSTORE(buffer, KERNEL(exp1)(VLOAD(buffer)));
+        for (size_t k = 0; i + k < n; k++) {
+            y[i + k] = buffer[k];
+        }
+    }
+}
+
+KERNEL_TARGET static void KERNEL(vsincos)(const real_t* x, real_t* s, real_t* c, size_t n)
+{
+    VREAL vs, vc;
+    size_t i = 0;
+    for (; i + VLEN <= n; i += VLEN) {
+        KERNEL(sincos1)(VLOAD(x + i), &vs, &vc);
+        VSTORE(s + i, vs);
+        VSTORE(c + i, vc);
+    }
+    if (i < n) {
+        real_t buffer_s[VLEN], buffer_c[VLEN];
+        for (size_t k = 0; k < VLEN; k++) {
+            buffer_s[k] = (i + k < n) ? x[i + k] : 1.0;
+        }
+        KERNEL(sincos1)(VLOAD(buffer_s), &vs, &vc);
+        VSTORE(buffer_s, vs);
+        VSTORE(buffer_c, vc);
+        for (size_t k = 0; i + k < n; k++) {
+            s[i + k] = buffer_s[k];
+            c[i + k] = buffer_c[k];
+        }
+    }
+}
+
+KERNEL_TARGET static void KERNEL(vatan2)(const real_t* y, const real_t* x, real_t* angle, size_t n)
+{
+    size_t i = 0;
+    for (; i + VLEN <= n; i += VLEN) {
+        VSTORE(angle + i, KERNEL(atan21)(VLOAD(y + i), VLOAD(x + i)));
+    }
+    if (i < n) {
+        real_t buffer_y[VLEN], buffer_x[VLEN];
+        for (size_t k = 0; k < VLEN; k++) {
+            buffer_y[k] = (i + k < n) ? y[i + k] : 1.0;
+            buffer_x[k] = (i + k < n) ? x[i + k] : 1.0;
+        }
+        VSTORE(buffer_y, KERNEL(atan21)(VLOAD(buffer_y), VLOAD(buffer_x)));
+        for (size_t k = 0; i + k < n; k++) {
+            angle[i + k] = buffer_y[k];
+        }
+    }
+}
+
+KERNEL_TARGET static void KERNEL(vabs2)(const complex_t* x, real_t* y, size_t n)
+{
+    size_t i = 0;
+#ifdef VHADD
+    for (; i + VLEN <= n; i += VLEN) {
+        const VREAL a = VLOAD((const real_t*)(x + i));
+        const VREAL b = VLOAD((const real_t*)(x + i) + VLEN);
+        VSTORE(y + i, VHADD(VMUL(a, a), VMUL(b, b)));
+    }
+#endif
+    for (; i < n; i++) {
+        y[i] = x[i].re * x[i].re + x[i].im * x[i].im;
+    }
+}
+
+static const vmath_kernel_t KERNEL(kernel) = { KERNEL_NAME, KERNEL(vlog), KERNEL(vexp), KERNEL(vsincos), KERNEL(vatan2), KERNEL(vabs2) };
+
+#undef KERNEL
+#undef KERNEL_NAME
+#undef KERNEL_TARGET
+#undef VREAL
+#undef VLEN
+#undef VINT
+#undef VLOAD
+#undef VSTORE
+#undef VSET1
+#undef VADD
+#undef VSUB
+#undef VMUL
+#undef VDIV
+#undef VSQRT
+#undef VMIN
+#undef VMAX
+#undef VMADD
+#undef VBITS
+#undef VFROM_BITS
+#undef VISET1
+#undef VIAND
+#undef VIOR
+#undef VIXOR
+#undef VIADD
+#undef VISUB
+#undef VISHL
+#undef VISHR
+#undef VHADD
@@ -6,7 +6,7 @@
 
 vocoder_context_t* create_vocoder_context(double period, size_t fftsize, double fo_floor, double fo_ceil, double fs)
 {
-    assert(ISPOW2(fftsize));
+    assert(is_supported_fftsize(fftsize));
     assert(fo_floor > 0);
     assert(fo_floor < fo_ceil);
     assert(fo_ceil < fs / 2);
@@ -19,16 +19,29 @@ vocoder_context_t* create_vocoder_context(double period, size_t fftsize, double
     vocoder->fo_ceil = fo_ceil;
     vocoder->fftsize = fftsize;
     vocoder->numbins = fftsize / 2 + 1;
-    vocoder->fft = create_fft(fftsize);
-    vocoder->ifft = create_ifft(fftsize);
+    vocoder->rfft = create_rfft(fftsize);
+    vocoder->irfft = create_irfft(fftsize);
+    vocoder->dct = create_dct(fftsize);
+    vocoder->dst = create_dst(fftsize);
 
     return vocoder;
 }
 
 void destroy_vocoder_context(vocoder_context_t** vocoder)
 {
-    destroy_fft(&(*vocoder)->fft);
-    destroy_ifft(&(*vocoder)->ifft);
+    destroy_rfft(&(*vocoder)->rfft);
+    destroy_irfft(&(*vocoder)->irfft);
+    destroy_dct(&(*vocoder)->dct);
+    destroy_dst(&(*vocoder)->dst);
     REIM_FREE(*vocoder);
     *vocoder = NULL;
 }
+
+size_t get_vocoder_scratch_length(const vocoder_context_t* vocoder)
+{
+    size_t length = get_fft_scratch_length(vocoder->rfft);
+    length = MAX(length, get_fft_scratch_length(vocoder->irfft));
+    length = MAX(length, get_fft_scratch_length(vocoder->dct));
+    length = MAX(length, get_fft_scratch_length(vocoder->dst));
+    return length;
+}
@@ -0,0 +1,115 @@
+#include "reim/worker_pool.h"
+#include "reim/memory.h"
+#include <assert.h>
+
+// Take the tasks of the current job until none is left (called with the mutex locked)
+static void run_worker_tasks(worker_pool_t* pool)
+{
+    while (pool->next < pool->count) {
+        const size_t index = pool->next++;
+        const worker_task_t task = pool->task;
+        void* userdata = pool->userdata;
+
+        unlock_mutex(&pool->mutex);
+        task(userdata, index);
+        lock_mutex(&pool->mutex);
+
+        if (++pool->finished == pool->count) {
+            notify_all_condition(&pool->done);
+        }
+    }
+}
+
+static void run_worker(void* argument)
+{
+    worker_pool_t* pool = (worker_pool_t*)argument;
+
+    // a worker started late may find a job already finished, then it only takes no task
+    size_t generation = 0;
+    lock_mutex(&pool->mutex);
+    while (true) {
+        while (!pool->stop && pool->generation == generation) {
+            wait_condition(&pool->wakeup, &pool->mutex);
+        }
+        if (pool->stop) {
+            break;
+        }
+        generation = pool->generation;
+        run_worker_tasks(pool);
+    }
+    unlock_mutex(&pool->mutex);
+}
+
+worker_pool_t* create_worker_pool(size_t num_workers)
+{
+    worker_pool_t* pool = REIM_ALLOC_SINGLE(worker_pool_t);
+    pool->num_workers = 0;
+    pool->workers = (num_workers > 0) ? REIM_ALLOC(num_workers, thread_t) : NULL;
+    init_mutex(&pool->mutex);
+    init_condition(&pool->wakeup);
+    init_condition(&pool->done);
+
+    pool->task = NULL;
+    pool->userdata = NULL;
+    pool->count = 0;
+    pool->next = 0;
+    pool->finished = 0;
+    pool->generation = 0;
+    pool->stop = false;
+
+    // num_workers counts the running threads, so that destroy_worker_pool() joins only those on failure
+    for (size_t i = 0; i < num_workers; i++) {
+        if (!create_thread(&pool->workers[i], run_worker, pool)) {
+            destroy_worker_pool(&pool);
+            return NULL;
+        }
+        pool->num_workers++;
+    }
+    return pool;
+}
+
+void destroy_worker_pool(worker_pool_t** pool)
+{
+    lock_mutex(&(*pool)->mutex);
+    (*pool)->stop = true;
+    notify_all_condition(&(*pool)->wakeup);
+    unlock_mutex(&(*pool)->mutex);
+    for (size_t i = 0; i < (*pool)->num_workers; i++) {
+        join_thread(&(*pool)->workers[i]);
+    }
+
+    destroy_condition(&(*pool)->done);
+    destroy_condition(&(*pool)->wakeup);
+    destroy_mutex(&(*pool)->mutex);
+    REIM_FREE((*pool)->workers);
+    REIM_FREE(*pool);
+    *pool = NULL;
+}
+
+void run_worker_pool(worker_pool_t* pool, worker_task_t task, void* userdata, size_t count)
+{
+    // a single task doesn't need to wake the workers
+    if (pool == NULL || pool->num_workers == 0 || count <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            task(userdata, i);
+        }
+        return;
+    }
+
+    lock_mutex(&pool->mutex);
+    assert(pool->finished == pool->count); // no job is running
+    pool->task = task;
+    pool->userdata = userdata;
+    pool->count = count;
+    pool->next = 0;
+    pool->finished = 0;
+    pool->generation++;
+    notify_all_condition(&pool->wakeup);
+
+    // the caller works as well, then waits for the tasks taken by the workers
+    run_worker_tasks(pool);
+    while (pool->finished < pool->count) {
+        wait_condition(&pool->done, &pool->mutex);
+    }
+    unlock_mutex(&pool->mutex);
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include "reim/defines.h"
 #include <stddef.h>
 
 namespace {
@@ -9,7 +10,7 @@ static bool isapprox(double a, double b, double eta)
     return diff <= eta;
 }
 
-static bool isapprox_array(size_t size, double* a, double* b, double eta)
+static bool isapprox_array(size_t size, const real_t* a, const real_t* b, double eta)
 {
     bool is_all_matched = true;
     for (size_t i = 0; i < size; i++) {
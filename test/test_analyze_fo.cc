@@ -0,0 +1,268 @@
+#include "doctest.h"
+#include "reim/analyze_fo.h"
+#include "reim/mathematics.h"
+#include "reim/memory.h"
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+namespace {
+
+// Harmonics with the fo gliding exponentially from fo_begin to fo_end with a vibrato (5 Hz, 2 %),
+// and white noise at -40 dB (the true fo of each sample in fo)
+std::vector<real_t> generate_glide(double fs, size_t length, double fo_begin, double fo_end, std::vector<double>& fo)
+{
+    std::vector<real_t> x(length);
+    fo.resize(length);
+    double phase = 0.0;
+    uint32_t seed = 1;
+    for (size_t i = 0; i < length; i++) {
+        fo[i] = fo_begin * pow(fo_end / fo_begin, (double)i / length) * (1.0 + 0.02 * sin(2.0 * REIM_PI * 5.0 * i / fs));
+        phase += 2.0 * REIM_PI * fo[i] / fs;
+        double sum = 0.0;
+        for (size_t h = 1; h * fo[i] < fs / 2 && h <= 30; h++) {
+            sum += sin(h * phase) / h;
+        }
+        seed = seed * 1664525u + 1013904223u;
+        x[i] = (real_t)(0.3 * sum + 0.003 * ((seed >> 8) / 8388608.0 - 1.0));
+    }
+    return x;
+}
+
+// Eager reference of the fo refinement (the instantaneous frequency of all the bins in advance)
+struct eager_fo_reference {
+    double fs;
+    std::vector<real_t> pspec;
+    std::vector<real_t> ifreqf;
+
+    double get_interpolated(const std::vector<real_t>& values, double freq) const
+    {
+        const size_t numbins = values.size();
+        const double position = CLAMP_INDEX(freq / (fs / 2) * (numbins - 1), numbins - 1);
+        const size_t index = (size_t)floor(position);
+        const double delta = position - index;
+        return (1.0 - delta) * values[index] + delta * values[index + 1];
+    }
+
+    double refine(double fo, double fo_floor, double fo_ceil) const
+    {
+        double sum_freq = 0.0, denominator = 0.0;
+        for (size_t h = 1; h <= 3; h++) {
+            const double weight = get_interpolated(pspec, fo * h);
+            sum_freq += get_interpolated(ifreqf, fo * h) * weight;
+            denominator += h * weight;
+        }
+        const double refined = sum_freq / denominator;
+        return (refined < fo_floor || refined > fo_ceil || fabs(refined - fo) > fo) ? fo : refined;
+    }
+
+    double score(double fo) const
+    {
+        double result = 1.0;
+        for (size_t h = 1; h <= 3; h++) {
+            result *= get_interpolated(pspec, fo * h);
+            result /= get_interpolated(pspec, fo * (h - 0.5));
+        }
+        return result;
+    }
+};
+
+// Value at the ratio (0: minimum, 1: maximum)
+double get_percentile(std::vector<double> values, double ratio)
+{
+    std::sort(values.begin(), values.end());
+    return values[(size_t)floor(ratio * (values.size() - 1))];
+}
+
+}
+
+TEST_CASE("analyze_fo")
+{
+    const double fs = 48000;
+    const size_t fftsize = 2048;
+    const size_t hopsize = 240; // 5 ms
+    vocoder_context_t* vocoder = create_vocoder_context(5.0, fftsize, 71.0, 800.0, fs);
+    std::vector<double> fo_true;
+    const std::vector<real_t> x = generate_glide(fs, (size_t)(2 * fs), 110.0, 330.0, fo_true);
+
+    SUBCASE("check the accuracy against the true fo")
+    {
+        fo_context_t* context = create_fo_context(vocoder);
+        std::vector<double> errors, candidate_errors;
+        for (size_t position = 0; position + fftsize + 1 <= x.size(); position += hopsize) {
+            const double fo = analyze_fo(vocoder, context, x.data() + position + 1, x.data() + position);
+            const double truth = fo_true[position + 1 + fftsize / 2];
+            errors.push_back(fabs(fo - truth));
+
+            // the closest candidate of the DIO channels before the refinement (relative error)
+            double candidate_error = 1.0;
+            for (size_t ch = 0; ch < context->num_candidates; ch++) {
+                double candidate, rsd;
+                if (get_fo_candidate(context, ch, &candidate, &rsd)) {
+                    candidate_error = MIN(candidate_error, fabs(candidate - truth) / truth);
+                }
+            }
+            candidate_errors.push_back(candidate_error);
+        }
+        const double median = get_percentile(errors, 0.5);
+        const double p95 = get_percentile(errors, 0.95);
+        MESSAGE("fo error: " << median << " Hz (median), " << p95 << " Hz (p95)");
+        CHECK(median < 0.1);
+        CHECK(p95 < 0.25);
+        CHECK(get_percentile(errors, 1.0) < 1.0); // no octave errors
+
+        const double candidate_median = get_percentile(candidate_errors, 0.5);
+        const double candidate_p95 = get_percentile(candidate_errors, 0.95);
+        MESSAGE("DIO candidate error: " << 100.0 * candidate_median << " % (median), " << 100.0 * candidate_p95 << " % (p95)");
+        CHECK(candidate_median < 0.002);
+        CHECK(candidate_p95 < 0.01);
+        destroy_fo_context(&context);
+    }
+
+    SUBCASE("check the lazy instantaneous frequency against the eager full spectrum")
+    {
+        fo_context_t* context = create_fo_context(vocoder);
+        const size_t numbins = context->numbins;
+        rfft_t* rfft = create_rfft(fftsize);
+        std::vector<complex_t> spec(numbins), specd(numbins);
+        eager_fo_reference reference;
+        reference.fs = fs;
+        reference.pspec.resize(numbins);
+        reference.ifreqf.resize(numbins);
+
+        // silence (the frames without any candidate or previous fo), the glide, then silence again
+        std::vector<real_t> y(2 * fftsize, 0.0);
+        y.insert(y.end(), x.begin(), x.begin() + x.size() / 2);
+        y.resize(y.size() + 2 * fftsize, 0.0);
+
+        bool is_all_matched = true;
+        size_t num_deferred = 0;
+        for (size_t position = 0; position + fftsize + 1 <= y.size(); position += hopsize) {
+            const real_t* input = y.data() + position + 1;
+            const real_t* input_delayed = y.data() + position;
+            const double fo_previous = context->fo_previous;
+            const double fo = analyze_fo(vocoder, context, input, input_delayed);
+
+            // all the bins of both spectra
+            real_t* waveform = (real_t*)spec.data();
+            real_t* waveform_delayed = (real_t*)specd.data();
+            for (size_t i = 0; i < fftsize; i++) {
+                waveform[i] = input[i] * context->window[i];
+                waveform_delayed[i] = input_delayed[i] * context->window[i];
+            }
+            execute_rfft_inplace(rfft, spec.data());
+            execute_rfft_inplace(rfft, specd.data());
+            for (size_t k = 0; k < numbins; k++) {
+                reference.pspec[k] = COMPLEX_ABS2(spec[k].re, spec[k].im) + 1e-15;
+                // INSTFREQ() with atan2() in double precision as in C (C++ overloads it for float)
+                const real_t re = spec[k].re * specd[k].re + spec[k].im * specd[k].im;
+                const real_t im = spec[k].im * specd[k].re - spec[k].re * specd[k].im;
+                reference.ifreqf[k] = (real_t)INSTFREQ((double)re, (double)im, 1.0, 0.0, fs);
+            }
+
+            // the bins evaluated lazily are the same
+            bool is_any_ready = false;
+            for (size_t k = 0; k < numbins; k++) {
+                if (context->ifreqf_ready[k]) {
+                    is_all_matched &= (context->ifreqf[k] == reference.ifreqf[k]);
+                    is_any_ready = true;
+                }
+            }
+            is_all_matched &= (context->specd_ready == is_any_ready);
+            num_deferred += context->specd_ready ? 0 : 1;
+
+            // fo from the same candidates with the eager spectra
+            double best_fo = -1.0, best_score = -1.0;
+            if (fo_previous > vocoder->fo_floor) {
+                best_fo = reference.refine(fo_previous, vocoder->fo_floor, vocoder->fo_ceil);
+                best_score = reference.score(best_fo);
+            }
+            for (size_t ch = 0; ch < context->num_candidates; ch++) {
+                double candidate, rsd;
+                if (!get_fo_candidate(context, ch, &candidate, &rsd) || isnan(candidate) || candidate < vocoder->fo_floor || candidate > vocoder->fo_ceil || rsd > 1.0) {
+                    continue;
+                }
+                const double fo_refined = reference.refine(candidate, vocoder->fo_floor, vocoder->fo_ceil);
+                const double score = reference.score(fo_refined);
+                if (best_score < score) {
+                    best_fo = fo_refined;
+                    best_score = score;
+                }
+            }
+            const bool is_valid = !(best_fo < vocoder->fo_floor || best_fo > vocoder->fo_ceil || best_score < 0);
+            is_all_matched &= (fo == (is_valid ? best_fo : 0.0));
+        }
+        CHECK(is_all_matched);
+        CHECK(num_deferred > 0);
+
+        destroy_rfft(&rfft);
+        destroy_fo_context(&context);
+    }
+
+    SUBCASE("check the streaming DIO against the DIO on each frame")
+    {
+        fo_context_t* context_frame = create_fo_context(vocoder);
+        fo_context_t* context_stream = create_fo_context_streaming(vocoder);
+
+        // the glide with a silent gap longer than the analysis windows of the stream
+        const size_t gap_begin = x.size() / 2;
+        const size_t gap_end = gap_begin + (size_t)(fs / 2);
+        std::vector<real_t> y(x.begin(), x.begin() + gap_begin);
+        y.resize(gap_end, 0.0);
+        y.insert(y.end(), x.begin() + gap_begin, x.end());
+
+        size_t num_voiced = 0, num_matched = 0, num_candidates_matched = 0, num_gap = 0;
+        bool is_all_expired = true, has_intervals = false;
+        size_t pushed = 0;
+        for (size_t position = 0; position + fftsize + 1 <= y.size(); position += hopsize) {
+            // every sample until the end of the frame
+            for (; pushed < position + fftsize + 1; pushed++) {
+                push_fo_stream(context_stream, y[pushed]);
+            }
+            const double fo_frame = analyze_fo(vocoder, context_frame, y.data() + position + 1, y.data() + position);
+            const double fo_stream = analyze_fo(vocoder, context_stream, y.data() + position + 1, y.data() + position);
+
+            // voiced frames away from the edges of the gap (the windows are filled)
+            const size_t end = position + fftsize + 1;
+            if (end + fftsize < gap_begin || (position > gap_end + fftsize)) {
+                num_voiced++;
+                num_matched += (fabs(fo_stream - fo_frame) < 0.01 * fo_frame) ? 1 : 0;
+
+                // the candidates of the stream by themselves (mean frequencies of the running statistics)
+                double candidate_error = 1.0;
+                for (size_t ch = 0; ch < context_stream->num_candidates; ch++) {
+                    double candidate, rsd;
+                    if (get_fo_candidate(context_stream, ch, &candidate, &rsd)) {
+                        candidate_error = MIN(candidate_error, fabs(candidate - fo_frame) / fo_frame);
+                    }
+                    has_intervals |= (get_fo_stream_intervals(context_stream, ch) > 0);
+                }
+                num_candidates_matched += (candidate_error < 0.02) ? 1 : 0;
+            }
+
+            // frames in the gap after the windows: all the events expired, and the running sums are cleared
+            if (position > gap_begin + fftsize && end < gap_end) {
+                num_gap++;
+                for (size_t ch = 0; ch < context_stream->num_candidates; ch++) {
+                    double candidate, rsd;
+                    is_all_expired &= (get_fo_stream_intervals(context_stream, ch) == 0);
+                    is_all_expired &= !get_fo_candidate(context_stream, ch, &candidate, &rsd);
+                }
+            }
+        }
+        MESSAGE("streaming fo within 1 % of the frame fo: " << num_matched << " of " << num_voiced << " voiced frames ("
+            << num_candidates_matched << " with a candidate within 2 %)");
+        CHECK(num_voiced > 0);
+        CHECK(has_intervals);
+        CHECK(num_matched >= 0.95 * num_voiced);
+        CHECK(num_candidates_matched >= 0.95 * num_voiced);
+        CHECK(num_gap > 0);
+        CHECK(is_all_expired);
+
+        destroy_fo_context(&context_stream);
+        destroy_fo_context(&context_frame);
+    }
+
+    destroy_vocoder_context(&vocoder);
+}
@@ -0,0 +1,105 @@
+#include "doctest.h"
+#include "reim/analyze_sp.h"
+#include "reim/mathematics.h"
+#include "reim/memory.h"
+#include <math.h>
+
+TEST_CASE("analyze_sp")
+{
+    const double fs = 16000;
+    const size_t fftsize = 1024;
+    vocoder_context_t* vocoder = create_vocoder_context(5.0, fftsize, 71.0, 800.0, fs);
+    const size_t numbins = vocoder->numbins;
+
+    // harmonics of 150 Hz with a formant at 700 Hz, and a broadband floor (chirp)
+    real_t* x = allocate_vector(fftsize);
+    real_t* sp1 = allocate_vector(numbins);
+    real_t* sp2 = allocate_vector(numbins);
+    for (size_t i = 0; i < fftsize; i++) {
+        x[i] = 1e-3 * sin(0.7 * i * i);
+        for (size_t h = 1; h * 150.0 < fs / 2; h++) {
+            const double formant = (h * 150.0 - 700.0) / 1000.0;
+            x[i] += sin(2.0 * REIM_PI * 150.0 * h * i / fs + 0.3 * h * h) * exp(-0.5 * formant * formant) / h;
+        }
+    }
+
+    sp_context_t* context = create_sp_context(vocoder);
+    sp_context_t* context_table = create_sp_context_tabulated(vocoder, REIM_SP_TABLE_RESOLUTION);
+
+    SUBCASE("check the window support")
+    {
+        // the window of the unvoiced frames: 3 periods of 200 Hz (240 samples) in the middle of the frame
+        const sp_window_t* window = &context->window_unvoiced;
+        CHECK(window->offset + window->length / 2 == fftsize / 2);
+        CHECK(window->length <= 240);
+        CHECK(window->length >= 238);
+        CHECK(window->window[0] > 0.0);
+        CHECK(window->window[window->length - 1] > 0.0);
+    }
+
+    SUBCASE("check the table: same as the direct computation at the entries and out of the range")
+    {
+        CHECK(context->table_size == 0);
+        CHECK(context_table->table_size == (size_t)ceil(log2(800.0 / 71.0) * REIM_SP_TABLE_RESOLUTION) + 1);
+
+        const double fo_entry = 71.0 * pow(2.0, 40 / REIM_SP_TABLE_RESOLUTION);
+        analyze_sp(vocoder, context, x, fo_entry, true, false, sp1);
+        analyze_sp(vocoder, context_table, x, fo_entry, true, false, sp2);
+        for (size_t k = 0; k < numbins; k++) {
+            CHECK(sp1[k] == sp2[k]);
+        }
+
+        const double fo_out = 60.0;
+        analyze_sp(vocoder, context, x, fo_out, true, false, sp1);
+        analyze_sp(vocoder, context_table, x, fo_out, true, false, sp2);
+        for (size_t k = 0; k < numbins; k++) {
+            CHECK(sp1[k] == sp2[k]);
+        }
+    }
+
+    SUBCASE("check the table: difference of the envelope between the entries")
+    {
+        // the fo in the middle of the entries
+        const double fo = 71.0 * pow(2.0, 40.5 / REIM_SP_TABLE_RESOLUTION);
+        analyze_sp(vocoder, context, x, fo, true, false, sp1);
+        analyze_sp(vocoder, context_table, x, fo, true, false, sp2);
+        double error = 0.0;
+        for (size_t k = 0; k < numbins; k++) {
+            const double diff = 10.0 * log10(sp2[k] / sp1[k]);
+            error += diff * diff;
+        }
+        error = sqrt(error / numbins);
+        MESSAGE("envelope difference of the table: " << error << " dB (RMS)");
+        CHECK(error < 0.5);
+    }
+
+    SUBCASE("check the log envelope against the envelope")
+    {
+        // voiced, unvoiced and silent frames (the log of the unvoiced frames is floored by 1e-12)
+        const bool isvoiced[] = { true, false, false };
+        const bool issilence[] = { false, false, true };
+        for (size_t n = 0; n < 3; n++) {
+            analyze_sp(vocoder, context, x, 150.0, isvoiced[n], issilence[n], sp1);
+            analyze_sp_log(vocoder, context, x, 150.0, isvoiced[n], issilence[n], sp2);
+            const double floor = (!isvoiced[n] && !issilence[n]) ? 1e-12 : 0.0;
+            double error = 0.0;
+            for (size_t k = 0; k < numbins; k++) {
+                const double expected = sp1[k] + floor;
+                error = MAX(error, fabs(exp(sp2[k]) - expected) / expected);
+            }
+            MESSAGE("relative error of the log envelope (frame " << n << "): " << error);
+#ifdef REIM_USE_FLOAT
+            CHECK(error < 1e-5);
+#else
+            CHECK(error < 1e-10);
+#endif
+        }
+    }
+
+    destroy_sp_context(&context_table);
+    destroy_sp_context(&context);
+    free_vector(sp2);
+    free_vector(sp1);
+    free_vector(x);
+    destroy_vocoder_context(&vocoder);
+}
@@ -0,0 +1,54 @@
+#include "doctest.h"
+#include "reim/audio_frame.h"
+#include "reim/memory.h"
+
+TEST_CASE("audio frame")
+{
+    const double fs = 16000;
+    const double period = 5.0; // 80 samples
+    const size_t fftsize = 256;
+    const size_t length = 1000;
+    real_t input[length];
+    for (size_t i = 0; i < length; i++) {
+        input[i] = (real_t)i;
+    }
+
+    SUBCASE("check block processing is equivalent to the sample-by-sample one")
+    {
+        audio_frame_t* frame_sample = create_audio_frame(fs, period, fftsize);
+        audio_frame_t* frame_block = create_audio_frame(fs, period, fftsize);
+        real_t* waveform = allocate_vector(fftsize + 1);
+
+        size_t position = 0;
+        size_t frames = 0;
+        for (size_t i = 0; i < length; i++) {
+            if (!next_audio_frame(frame_sample, input[i], waveform)) {
+                continue;
+            }
+
+            // the block processing stops at the same frame
+            bool has_new_frame = false;
+            position += next_audio_frame_block(frame_block, input + position, length - position, &has_new_frame);
+            CHECK(has_new_frame);
+            CHECK(position == i + 1);
+            CHECK(frame_block->outputsize == frame_sample->outputsize);
+
+            const real_t* view = get_audio_frame(frame_block);
+            CHECK(view[fftsize] == input[i]);
+            for (size_t k = 0; k <= fftsize; k++) {
+                CHECK(view[k] == waveform[k]);
+            }
+            frames++;
+        }
+        CHECK(frames == 13);
+
+        // the rest of the input has no frame
+        bool has_new_frame = true;
+        CHECK(next_audio_frame_block(frame_block, input + position, length - position, &has_new_frame) == length - position);
+        CHECK(!has_new_frame);
+
+        free_vector(waveform);
+        destroy_audio_frame(&frame_sample);
+        destroy_audio_frame(&frame_block);
+    }
+}
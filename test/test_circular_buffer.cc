@@ -3,7 +3,7 @@
 
 TEST_CASE("circular buffer")
 {
-    double buffer[4] = { 12, 34, 56, 78 }; // dummy values
+    real_t buffer[4] = { 12, 34, 56, 78 }; // dummy values
     circular_buffer_t* cb = create_circular_buffer(4);
 
     SUBCASE("check initial state")
@@ -40,5 +40,70 @@ TEST_CASE("circular buffer")
         CHECK(buffer[3] == 5.0);
     }
 
+    SUBCASE("check block push")
+    {
+        const real_t values[6] = { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0 };
+        push_circular_buffer(cb, 1.0);
+        push_block_circular_buffer(cb, values, 2);
+        push_block_circular_buffer(cb, values + 2, 3); // across the end of the buffer
+        copy_all_circular_buffer(cb, buffer);
+        CHECK(buffer[0] == 2.0);
+        CHECK(buffer[1] == 3.0);
+        CHECK(buffer[2] == 4.0);
+        CHECK(buffer[3] == 5.0);
+
+        push_block_circular_buffer(cb, values, 6); // longer than the capacity
+        copy_all_circular_buffer(cb, buffer);
+        CHECK(buffer[0] == 3.0);
+        CHECK(buffer[1] == 4.0);
+        CHECK(buffer[2] == 5.0);
+        CHECK(buffer[3] == 6.0);
+    }
+
+    SUBCASE("check contiguous view")
+    {
+        for (size_t i = 1; i <= 7; i++) {
+            push_circular_buffer(cb, (real_t)i);
+            const real_t* view = get_all_circular_buffer(cb);
+            for (size_t k = 0; k < 4; k++) {
+                CHECK(view[k] == ((i + k >= 3) ? (real_t)(i + k - 3) : 0.0));
+            }
+        }
+    }
+
+    destroy_circular_buffer(&cb);
+}
+
+TEST_CASE("circular buffer bulk operations")
+{
+    // not a power of two
+    const size_t capacity = 5;
+    circular_buffer_t* cb = create_circular_buffer(capacity);
+    circular_buffer_t* reference = create_circular_buffer(capacity);
+    CHECK(cb->mask + 1 == 8);
+
+    SUBCASE("check against the scalar path")
+    {
+        const size_t lengths[] = { 3, 4, 1, 0, 5, 7, 2, 6, 13 };
+        real_t values[13], expected[capacity];
+        real_t value = 1.0;
+        for (size_t n = 0; n < sizeof(lengths) / sizeof(lengths[0]); n++) {
+            for (size_t i = 0; i < lengths[n]; i++) {
+                values[i] = value;
+                push_circular_buffer(reference, value);
+                value += 1.0;
+            }
+            push_block_circular_buffer(cb, values, lengths[n]);
+
+            // the view holds the same values as the scalar pushes
+            copy_all_circular_buffer(reference, expected);
+            const real_t* view = get_all_circular_buffer(cb);
+            for (size_t k = 0; k < capacity; k++) {
+                CHECK(view[k] == expected[k]);
+            }
+        }
+    }
+
     destroy_circular_buffer(&cb);
+    destroy_circular_buffer(&reference);
 }
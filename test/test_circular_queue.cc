@@ -1,5 +1,58 @@
 #include "doctest.h"
 #include "reim/circular_queue.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// Scalar reference of the queue (element by element)
+struct reference_queue {
+    size_t head = 0;
+    size_t remaining = 0;
+    std::vector<real_t> buffer;
+
+    explicit reference_queue(size_t capacity)
+        : buffer(capacity, 0.0)
+    {
+    }
+
+    void push_additive(const real_t* values, size_t size)
+    {
+        const size_t capacity = buffer.size();
+        size_t index = head;
+        for (size_t i = 0; i < size; i++) {
+            if (i >= capacity) {
+                buffer[index] = values[i];
+                head = (head + 1) % capacity;
+            } else {
+                buffer[index] += values[i];
+            }
+            index = (index + 1) % capacity;
+        }
+        remaining = std::min(std::max(size, remaining), capacity);
+    }
+
+    void push_additive_offset(size_t offset, const real_t* values, size_t size)
+    {
+        std::vector<real_t> padded(offset, 0.0);
+        padded.insert(padded.end(), values, values + size);
+        push_additive(padded.data(), padded.size());
+    }
+
+    real_t pop()
+    {
+        if (remaining == 0) {
+            return 0.0;
+        }
+        real_t value = buffer[head];
+        buffer[head] = 0.0;
+        head = (head + 1) % buffer.size();
+        remaining--;
+        return value;
+    }
+};
+
+}
 
 TEST_CASE("circular queue")
 {
@@ -7,7 +60,7 @@ TEST_CASE("circular queue")
 
     SUBCASE("check single push")
     {
-        double buffer[2] = { 1.0, 2.0 };
+        real_t buffer[2] = { 1.0, 2.0 };
 
         CHECK(get_remaining_circular_queue(queue) == 0);
         // [ 0 0 0 0 ]
@@ -35,7 +88,7 @@ TEST_CASE("circular queue")
 
     SUBCASE("check additive buffer")
     {
-        double buffer[2] = { 1.0, 2.0 };
+        real_t buffer[2] = { 1.0, 2.0 };
 
         push_additive_circular_queue(queue, buffer, 2);
         CHECK(get_remaining_circular_queue(queue) == 2);
@@ -60,7 +113,7 @@ TEST_CASE("circular queue")
 
     SUBCASE("check fill")
     {
-        double buffer[5] = { 1.0, 2.0, 3.0, 4.0, 5.0 };
+        real_t buffer[5] = { 1.0, 2.0, 3.0, 4.0, 5.0 };
 
         push_additive_circular_queue(queue, buffer, 5);
         CHECK(get_remaining_circular_queue(queue) == 4);
@@ -83,5 +136,104 @@ TEST_CASE("circular queue")
         // [ 0 0 0 0 ] -> 5
     }
 
+    SUBCASE("check block pop")
+    {
+        real_t buffer[3] = { 1.0, 2.0, 3.0 };
+        real_t output[4] = { 12, 34, 56, 78 }; // dummy values
+
+        CHECK(pop_circular_queue(queue) == 0.0);
+        CHECK(pop_circular_queue(queue) == 0.0);
+        push_additive_circular_queue(queue, buffer, 3);
+        // [ 1 2 3 0 ] (from the head)
+
+        pop_block_circular_queue(queue, output, 2);
+        CHECK(output[0] == 1.0);
+        CHECK(output[1] == 2.0);
+        CHECK(get_remaining_circular_queue(queue) == 1);
+        // [ 3 0 0 0 ] -> 1 2
+
+        push_additive_circular_queue(queue, buffer, 3);
+        // [ 4 2 3 0 ] (across the end of the buffer)
+
+        pop_block_circular_queue(queue, output, 4);
+        CHECK(output[0] == 4.0);
+        CHECK(output[1] == 2.0);
+        CHECK(output[2] == 3.0);
+        CHECK(output[3] == 0.0);
+        CHECK(get_remaining_circular_queue(queue) == 0);
+        // [ 0 0 0 0 ] -> 4 2 3 0
+
+        push_additive_circular_queue(queue, buffer, 1);
+        CHECK(pop_circular_queue(queue) == 1.0);
+        // the popped values are cleared
+    }
+
+    destroy_circular_queue(&queue);
+}
+
+TEST_CASE("circular queue bulk operations")
+{
+    const size_t capacity = 16;
+    circular_queue_t* queue = create_circular_queue(capacity);
+    reference_queue reference(capacity);
+
+    SUBCASE("check the capacity")
+    {
+        circular_queue_t* rounded = create_circular_queue(13);
+        CHECK(rounded->capacity == 16);
+        destroy_circular_queue(&rounded);
+    }
+
+    SUBCASE("check against the scalar path")
+    {
+        // pushes across the end of the buffer and overflows, pops longer than the remaining values
+        const size_t push_sizes[] = { 5, 12, 3, 16, 7, 20, 1, 40, 9, 0, 15 };
+        const size_t pop_sizes[] = { 3, 7, 1, 10, 16, 4, 2, 0, 25, 6, 11 };
+        real_t values[40], output[25];
+        real_t value = 1.0;
+        for (size_t n = 0; n < sizeof(push_sizes) / sizeof(push_sizes[0]); n++) {
+            for (size_t i = 0; i < push_sizes[n]; i++) {
+                values[i] = value;
+                value += 1.0;
+            }
+            push_additive_circular_queue(queue, values, push_sizes[n]);
+            reference.push_additive(values, push_sizes[n]);
+            CHECK(get_remaining_circular_queue(queue) == reference.remaining);
+
+            // block pop, then single pop
+            pop_block_circular_queue(queue, output, pop_sizes[n]);
+            for (size_t i = 0; i < pop_sizes[n]; i++) {
+                CHECK(output[i] == reference.pop());
+            }
+            CHECK(pop_circular_queue(queue) == reference.pop());
+            CHECK(get_remaining_circular_queue(queue) == reference.remaining);
+        }
+    }
+
+    SUBCASE("check offset pushes against the scalar path")
+    {
+        // offsets within and beyond the remaining values, and overflows of the values and of the offset itself
+        const size_t offsets[] = { 3, 0, 10, 14, 2, 20, 5, 0, 17 };
+        const size_t push_sizes[] = { 5, 12, 3, 9, 16, 4, 30, 7, 1 };
+        const size_t pop_sizes[] = { 2, 7, 1, 10, 3, 6, 5, 25, 0 };
+        real_t values[30], output[25];
+        real_t value = 1.0;
+        for (size_t n = 0; n < sizeof(offsets) / sizeof(offsets[0]); n++) {
+            for (size_t i = 0; i < push_sizes[n]; i++) {
+                values[i] = value;
+                value += 1.0;
+            }
+            push_additive_offset_circular_queue(queue, offsets[n], values, push_sizes[n]);
+            reference.push_additive_offset(offsets[n], values, push_sizes[n]);
+            CHECK(get_remaining_circular_queue(queue) == reference.remaining);
+
+            pop_block_circular_queue(queue, output, pop_sizes[n]);
+            for (size_t i = 0; i < pop_sizes[n]; i++) {
+                CHECK(output[i] == reference.pop());
+            }
+            CHECK(get_remaining_circular_queue(queue) == reference.remaining);
+        }
+    }
+
     destroy_circular_queue(&queue);
 }
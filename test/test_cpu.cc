@@ -0,0 +1,182 @@
+#include "doctest.h"
+#include "reim/cpu.h"
+#include "reim/fft.h"
+#include "reim/thread.h"
+#include "reim/vmath.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace {
+
+#ifdef REIM_USE_FLOAT
+const double cpu_eta = 1e-5;
+#else
+const double cpu_eta = 1e-13;
+#endif
+
+// Outputs of every kernel family with the selected instruction set
+struct cpu_outputs {
+    std::vector<real_t> fft_re, fft_im, rfft;
+    std::vector<real_t> log, exp, sin, cos, atan2, abs2;
+};
+
+cpu_outputs run_kernels(size_t n)
+{
+    cpu_outputs out;
+
+    // mixed radix 2, 3, 4, 5
+    const size_t fftsize = get_next_fftsize(480);
+    out.fft_re.resize(fftsize);
+    out.fft_im.resize(fftsize);
+    out.rfft.resize(fftsize + 2);
+    for (size_t i = 0; i < fftsize; i++) {
+        out.fft_re[i] = (real_t)((i * 7919 % 101) / 50.0 - 1.0);
+        out.fft_im[i] = (real_t)((i * 104729 % 97) / 48.0 - 1.0);
+        out.rfft[i] = out.fft_re[i];
+    }
+    fft_t* fft = create_fft(fftsize);
+    execute_fft(fft, out.fft_re.data(), out.fft_im.data());
+    destroy_fft(&fft);
+    rfft_t* rfft = create_rfft(fftsize);
+    execute_rfft_inplace(rfft, (complex_t*)out.rfft.data());
+    destroy_rfft(&rfft);
+
+    std::vector<real_t> x(n), y(n);
+    std::vector<complex_t> z(n);
+    for (size_t i = 0; i < n; i++) {
+        x[i] = (real_t)(0.01 + 0.37 * i);
+        y[i] = (real_t)(5.0 - 0.11 * i);
+        z[i].re = x[i];
+        z[i].im = y[i];
+    }
+    out.log.resize(n);
+    out.exp.resize(n);
+    out.sin.resize(n);
+    out.cos.resize(n);
+    out.atan2.resize(n);
+    out.abs2.resize(n);
+    vlog(x.data(), out.log.data(), n);
+    vexp(y.data(), out.exp.data(), n);
+    vsincos(x.data(), out.sin.data(), out.cos.data(), n);
+    vatan2(y.data(), x.data(), out.atan2.data(), n);
+    vabs2(z.data(), out.abs2.data(), n);
+    return out;
+}
+
+bool ismatched(const std::vector<real_t>& a, const std::vector<real_t>& b)
+{
+    bool is_all_matched = (a.size() == b.size());
+    for (size_t i = 0; i < a.size() && i < b.size(); i++) {
+        const double scale = (b[i] > 1.0) ? b[i] : (b[i] < -1.0) ? -b[i] : 1.0;
+        const double diff = (a[i] > b[i]) ? a[i] - b[i] : b[i] - a[i];
+        is_all_matched &= (diff <= cpu_eta * scale);
+    }
+    return is_all_matched;
+}
+
+// Kernels run on the other thread while the instruction set is switched
+struct kernel_thread {
+    thread_t thread;
+    const cpu_outputs* expected;
+    size_t n;
+    size_t iterations;
+    bool is_all_matched;
+};
+
+void run_kernel_thread(void* argument)
+{
+    kernel_thread* self = (kernel_thread*)argument;
+    self->is_all_matched = true;
+    for (size_t i = 0; i < self->iterations; i++) {
+        const cpu_outputs actual = run_kernels(self->n);
+        self->is_all_matched &= ismatched(actual.fft_re, self->expected->fft_re)
+            && ismatched(actual.rfft, self->expected->rfft)
+            && ismatched(actual.exp, self->expected->exp)
+            && ismatched(actual.atan2, self->expected->atan2);
+    }
+}
+
+}
+
+TEST_CASE("CPU information")
+{
+    printf("Supported instruction sets:");
+    for (int isa = 0; isa < CPU_ISA_COUNT; isa++) {
+        if (is_cpu_isa_supported((cpu_isa_t)isa)) {
+            printf(" %s", get_cpu_isa_name((cpu_isa_t)isa));
+        }
+    }
+    printf(" (kernels: %s)\n", get_cpu_isa_name(get_kernel_isa()));
+}
+
+TEST_CASE("kernel dispatch")
+{
+    SUBCASE("check the selection")
+    {
+        CHECK(is_cpu_isa_supported(CPU_ISA_SCALAR));
+        CHECK(is_cpu_isa_supported(get_kernel_isa()));
+        CHECK(!is_cpu_isa_supported(CPU_ISA_COUNT));
+        CHECK(strcmp(get_cpu_isa_name(CPU_ISA_AVX2), "avx2") == 0);
+
+        const cpu_isa_t isa = get_kernel_isa();
+        CHECK(set_kernel_isa(CPU_ISA_SCALAR));
+        CHECK(get_kernel_isa() == CPU_ISA_SCALAR);
+        CHECK(strcmp(get_vmath_kernel_name(), "scalar") == 0);
+        CHECK(!set_kernel_isa(CPU_ISA_COUNT));
+        CHECK(get_kernel_isa() == CPU_ISA_SCALAR);
+        reset_kernel_isa();
+        CHECK(get_kernel_isa() == isa);
+    }
+
+    SUBCASE("check every instruction set against the scalar kernels")
+    {
+        // odd length for the tails of the vector kernels
+        const size_t n = 203;
+        REQUIRE(set_kernel_isa(CPU_ISA_SCALAR));
+        const cpu_outputs expected = run_kernels(n);
+        for (int isa = CPU_ISA_SCALAR + 1; isa < CPU_ISA_COUNT; isa++) {
+            if (!set_kernel_isa((cpu_isa_t)isa)) {
+                continue;
+            }
+            INFO("instruction set: " << get_cpu_isa_name((cpu_isa_t)isa));
+            const cpu_outputs actual = run_kernels(n);
+            CHECK(ismatched(actual.fft_re, expected.fft_re));
+            CHECK(ismatched(actual.fft_im, expected.fft_im));
+            CHECK(ismatched(actual.rfft, expected.rfft));
+            CHECK(ismatched(actual.log, expected.log));
+            CHECK(ismatched(actual.exp, expected.exp));
+            CHECK(ismatched(actual.sin, expected.sin));
+            CHECK(ismatched(actual.cos, expected.cos));
+            CHECK(ismatched(actual.atan2, expected.atan2));
+            CHECK(ismatched(actual.abs2, expected.abs2));
+        }
+        reset_kernel_isa();
+    }
+
+    SUBCASE("check the switch while the kernels are running on the other threads")
+    {
+        const size_t n = 203;
+        REQUIRE(set_kernel_isa(CPU_ISA_SCALAR));
+        const cpu_outputs expected = run_kernels(n);
+
+        kernel_thread threads[2];
+        for (size_t t = 0; t < 2; t++) {
+            threads[t].expected = &expected;
+            threads[t].n = n;
+            threads[t].iterations = 50;
+            REQUIRE(create_thread(&threads[t].thread, run_kernel_thread, &threads[t]));
+        }
+        for (size_t i = 0; i < 200; i++) {
+            const cpu_isa_t isa = (cpu_isa_t)(i % CPU_ISA_COUNT);
+            set_kernel_isa(isa);
+            CHECK(is_cpu_isa_supported(get_kernel_isa()));
+            reset_kernel_isa();
+        }
+        for (size_t t = 0; t < 2; t++) {
+            join_thread(&threads[t].thread);
+            CHECK(threads[t].is_all_matched);
+        }
+        reset_kernel_isa();
+    }
+}
@@ -0,0 +1,53 @@
+#include "doctest.h"
+#include "isapprox.hh"
+#include "reim/decimator.h"
+#include "reim/mathematics.h"
+
+TEST_CASE("decimator")
+{
+    const size_t length = 1200;
+    const size_t count = 40;
+    const size_t offset = 400; // away from the edges
+    real_t x[length], y[count];
+
+    SUBCASE("check factor 1: no filtering")
+    {
+        decimator_t* decimator = create_decimator(1);
+        for (size_t i = 0; i < length; i++) {
+            x[i] = sin(0.3 * i);
+        }
+        execute_decimator(decimator, x, length, offset, y, count);
+        CHECK(isapprox_array(count, y, x + offset, 1e-12));
+        destroy_decimator(&decimator);
+    }
+
+    SUBCASE("check DC gain")
+    {
+        decimator_t* decimator = create_decimator(6);
+        for (size_t i = 0; i < length; i++) {
+            x[i] = 1.0;
+        }
+        execute_decimator(decimator, x, length, offset, y, count);
+        for (size_t m = 0; m < count; m++) {
+            CHECK(isapprox(y[m], 1.0, 1e-6));
+        }
+        destroy_decimator(&decimator);
+    }
+
+    SUBCASE("check passband and stopband")
+    {
+        // passband: 0.25 of the decimated Nyquist frequency, stopband: above 1.5 times
+        const size_t factor = 6;
+        decimator_t* decimator = create_decimator(factor);
+        const double omega_pass = 0.25 * REIM_PI / factor;
+        const double omega_stop = 1.5 * REIM_PI / factor;
+        for (size_t i = 0; i < length; i++) {
+            x[i] = sin(omega_pass * i) + sin(omega_stop * i);
+        }
+        execute_decimator(decimator, x, length, offset, y, count);
+        for (size_t m = 0; m < count; m++) {
+            CHECK(isapprox(y[m], sin(omega_pass * (offset + m * factor)), 1e-3));
+        }
+        destroy_decimator(&decimator);
+    }
+}
@@ -1,7 +1,10 @@
 #include "doctest.h"
 #include "isapprox.hh"
 #include "reim/fft.h"
+#include "reim/mathematics.h"
 #include <stdio.h>
+#include <thread>
+#include <vector>
 
 TEST_CASE("FFT information")
 {
@@ -15,10 +18,10 @@ TEST_CASE("FFT")
 
     SUBCASE("check FFT: complex-exp (1)")
     {
-        double xr[8] = { +1, 0, -1, 0, +1, 0, -1, 0 };
-        double xi[8] = { 0, +1, 0, -1, 0, +1, 0, -1 };
-        double Xr[8] = { 0, 0, 8, 0, 0, 0, 0, 0 };
-        double Xi[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+        real_t xr[8] = { +1, 0, -1, 0, +1, 0, -1, 0 };
+        real_t xi[8] = { 0, +1, 0, -1, 0, +1, 0, -1 };
+        real_t Xr[8] = { 0, 0, 8, 0, 0, 0, 0, 0 };
+        real_t Xi[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
         execute_fft(fft, xr, xi);
         CHECK(isapprox_array(fftsize, xr, Xr, 1e-8));
         CHECK(isapprox_array(fftsize, xi, Xi, 1e-8));
@@ -26,10 +29,10 @@ TEST_CASE("FFT")
 
     SUBCASE("check FFT: complex-exp (2)")
     {
-        double xr[8] = { 0, -1, 0, +1, 0, -1, 0, +1 };
-        double xi[8] = { +1, 0, -1, 0, +1, 0, -1, 0 };
-        double Xr[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
-        double Xi[8] = { 0, 0, 8, 0, 0, 0, 0, 0 };
+        real_t xr[8] = { 0, -1, 0, +1, 0, -1, 0, +1 };
+        real_t xi[8] = { +1, 0, -1, 0, +1, 0, -1, 0 };
+        real_t Xr[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+        real_t Xi[8] = { 0, 0, 8, 0, 0, 0, 0, 0 };
         execute_fft(fft, xr, xi);
         CHECK(isapprox_array(fftsize, xr, Xr, 1e-8));
         CHECK(isapprox_array(fftsize, xi, Xi, 1e-8));
@@ -45,10 +48,10 @@ TEST_CASE("IFFT")
 
     SUBCASE("check IFFT: complex-exp (1)")
     {
-        double Xr[8] = { 0, 0, 8, 0, 0, 0, 0, 0 };
-        double Xi[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
-        double xr[8] = { +1, 0, -1, 0, +1, 0, -1, 0 };
-        double xi[8] = { 0, +1, 0, -1, 0, +1, 0, -1 };
+        real_t Xr[8] = { 0, 0, 8, 0, 0, 0, 0, 0 };
+        real_t Xi[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+        real_t xr[8] = { +1, 0, -1, 0, +1, 0, -1, 0 };
+        real_t xi[8] = { 0, +1, 0, -1, 0, +1, 0, -1 };
         execute_ifft(ifft, Xr, Xi);
         CHECK(isapprox_array(fftsize, Xr, xr, 1e-8));
         CHECK(isapprox_array(fftsize, Xi, xi, 1e-8));
@@ -56,10 +59,10 @@ TEST_CASE("IFFT")
 
     SUBCASE("check IFFT: complex-exp (2)")
     {
-        double Xr[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
-        double Xi[8] = { 0, 0, 8, 0, 0, 0, 0, 0 };
-        double xr[8] = { 0, -1, 0, +1, 0, -1, 0, +1 };
-        double xi[8] = { +1, 0, -1, 0, +1, 0, -1, 0 };
+        real_t Xr[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+        real_t Xi[8] = { 0, 0, 8, 0, 0, 0, 0, 0 };
+        real_t xr[8] = { 0, -1, 0, +1, 0, -1, 0, +1 };
+        real_t xi[8] = { +1, 0, -1, 0, +1, 0, -1, 0 };
         execute_ifft(ifft, Xr, Xi);
         CHECK(isapprox_array(fftsize, Xr, xr, 1e-8));
         CHECK(isapprox_array(fftsize, Xi, xi, 1e-8));
@@ -68,6 +71,462 @@ TEST_CASE("IFFT")
     destroy_ifft(&ifft);
 }
 
+TEST_CASE("RFFT")
+{
+    const size_t fftsize = 8;
+    const size_t numbins = fftsize / 2 + 1;
+    rfft_t* rfft = create_rfft(fftsize);
+
+    SUBCASE("check RFFT: cosine")
+    {
+        real_t x[8] = { +1, 0, -1, 0, +1, 0, -1, 0 };
+        real_t Xr[5] = { 9, 9, 9, 9, 9 }; // dummy values
+        real_t Xi[5] = { 9, 9, 9, 9, 9 }; // dummy values
+        real_t Yr[5] = { 0, 0, 4, 0, 0 };
+        real_t Yi[5] = { 0, 0, 0, 0, 0 };
+        execute_rfft(rfft, x, Xr, Xi);
+        CHECK(isapprox_array(numbins, Xr, Yr, 1e-8));
+        CHECK(isapprox_array(numbins, Xi, Yi, 1e-8));
+    }
+
+    SUBCASE("check RFFT: sine and Nyquist")
+    {
+        real_t x[8] = { +1, 0, +1, -2, +1, 0, +1, -2 };
+        real_t Xr[5] = { 9, 9, 9, 9, 9 }; // dummy values
+        real_t Xi[5] = { 9, 9, 9, 9, 9 }; // dummy values
+        real_t Yr[5] = { 0, 0, 0, 0, 8 };
+        real_t Yi[5] = { 0, 0, -4, 0, 0 };
+        execute_rfft(rfft, x, Xr, Xi);
+        CHECK(isapprox_array(numbins, Xr, Yr, 1e-8));
+        CHECK(isapprox_array(numbins, Xi, Yi, 1e-8));
+    }
+
+    destroy_rfft(&rfft);
+}
+
+TEST_CASE("IRFFT")
+{
+    const size_t fftsize = 8;
+    irfft_t* irfft = create_irfft(fftsize);
+
+    SUBCASE("check IRFFT: sine and Nyquist")
+    {
+        real_t Xr[5] = { 0, 0, 0, 0, 8 };
+        real_t Xi[5] = { 0, 0, -4, 0, 0 };
+        real_t x[8] = { 9, 9, 9, 9, 9, 9, 9, 9 }; // dummy values
+        real_t y[8] = { +1, 0, +1, -2, +1, 0, +1, -2 };
+        execute_irfft(irfft, Xr, Xi, x);
+        CHECK(isapprox_array(fftsize, x, y, 1e-8));
+    }
+
+    SUBCASE("check IRFFT: inverse of RFFT")
+    {
+        rfft_t* rfft = create_rfft(fftsize);
+        real_t x[8] = { 0.5, -1.5, 2.0, 3.25, -0.75, 1.0, 0.0, -2.5 };
+        real_t y[8] = { 9, 9, 9, 9, 9, 9, 9, 9 }; // dummy values
+        real_t Xr[5], Xi[5];
+        execute_rfft(rfft, x, Xr, Xi);
+        execute_irfft(irfft, Xr, Xi, y);
+        CHECK(isapprox_array(fftsize, x, y, 1e-8));
+        destroy_rfft(&rfft);
+    }
+
+    SUBCASE("check IRFFT: imaginary parts of DC and Nyquist are ignored")
+    {
+        real_t Xr[5] = { 0, 0, 0, 0, 8 };
+        real_t Xi[5] = { 3, 0, -4, 0, -5 };
+        real_t x[8] = { 9, 9, 9, 9, 9, 9, 9, 9 }; // dummy values
+        real_t y[8] = { +1, 0, +1, -2, +1, 0, +1, -2 };
+        execute_irfft(irfft, Xr, Xi, x);
+        CHECK(isapprox_array(fftsize, x, y, 1e-8));
+    }
+
+    destroy_irfft(&irfft);
+}
+
+TEST_CASE("in-place FFT")
+{
+    const size_t fftsize = 8;
+
+    SUBCASE("check FFT/IFFT: complex-exp (unnormalized inverse)")
+    {
+        fft_t* fft = create_fft(fftsize);
+        ifft_t* ifft = create_ifft(fftsize);
+        complex_t x[8] = { { +1, 0 }, { 0, +1 }, { -1, 0 }, { 0, -1 }, { +1, 0 }, { 0, +1 }, { -1, 0 }, { 0, -1 } };
+        execute_fft_inplace(fft, x);
+        CHECK(isapprox(x[2].re, 8, 1e-8));
+        CHECK(isapprox(x[2].im, 0, 1e-8));
+        CHECK(isapprox(x[3].re, 0, 1e-8));
+        CHECK(isapprox(x[3].im, 0, 1e-8));
+        execute_ifft_inplace(ifft, x);
+        CHECK(isapprox(x[0].re, 8, 1e-8));
+        CHECK(isapprox(x[1].im, 8, 1e-8));
+        CHECK(isapprox(x[2].re, -8, 1e-8));
+        CHECK(isapprox(x[3].im, -8, 1e-8));
+        destroy_fft(&fft);
+        destroy_ifft(&ifft);
+    }
+
+    SUBCASE("check RFFT/IRFFT: sine and Nyquist (unnormalized inverse)")
+    {
+        rfft_t* rfft = create_rfft(fftsize);
+        irfft_t* irfft = create_irfft(fftsize);
+        real_t y[8] = { +1, 0, +1, -2, +1, 0, +1, -2 };
+        complex_t X[5];
+        real_t* x = (real_t*)X;
+        for (size_t i = 0; i < fftsize; i++) {
+            x[i] = y[i];
+        }
+        execute_rfft_inplace(rfft, X);
+        CHECK(isapprox(X[0].re, 0, 1e-8));
+        CHECK(isapprox(X[2].im, -4, 1e-8));
+        CHECK(isapprox(X[4].re, 8, 1e-8));
+        CHECK(isapprox(X[4].im, 0, 1e-8));
+        execute_irfft_inplace(irfft, X);
+        for (size_t i = 0; i < fftsize; i++) {
+            CHECK(isapprox(x[i], y[i] * fftsize, 1e-8));
+        }
+        destroy_rfft(&rfft);
+        destroy_irfft(&irfft);
+    }
+}
+
+TEST_CASE("batched IRFFT")
+{
+    const size_t fftsize = 8;
+    const size_t numbins = fftsize / 2 + 1;
+    const size_t count = 3;
+    irfft_batch_t* batch = create_irfft_batch(fftsize, count);
+    irfft_t* irfft = create_irfft(fftsize);
+
+    SUBCASE("check batch: same as each IRFFT")
+    {
+        complex_t X[count * numbins];
+        complex_t Y[count * numbins];
+        for (size_t i = 0; i < count * numbins; i++) {
+            X[i].re = Y[i].re = 0.25 * i - 1.0;
+            X[i].im = Y[i].im = (i % numbins == 0 || i % numbins == numbins - 1) ? 0.0 : 0.5 * (i % 3);
+        }
+        execute_irfft_batch(batch, X);
+        for (size_t c = 0; c < count; c++) {
+            execute_irfft_inplace(irfft, Y + c * numbins);
+            CHECK(isapprox_array(fftsize, (real_t*)(X + c * numbins), (real_t*)(Y + c * numbins), 1e-8));
+        }
+    }
+
+    destroy_irfft_batch(&batch);
+    destroy_irfft(&irfft);
+}
+
+TEST_CASE("FFT plan cache")
+{
+    const size_t fftsize = 16;
+    warmup_fft(fftsize);
+
+    SUBCASE("check shared plans: same results from each object")
+    {
+        fft_t* fft1 = create_fft(fftsize);
+        fft_t* fft2 = create_fft(fftsize);
+        real_t x1[fftsize], y1[fftsize], x2[fftsize], y2[fftsize];
+        for (size_t i = 0; i < fftsize; i++) {
+            x1[i] = x2[i] = sin(0.3 * i) + 0.1 * i;
+            y1[i] = y2[i] = cos(0.7 * i);
+        }
+        execute_fft(fft1, x1, y1);
+        execute_fft(fft2, x2, y2);
+        CHECK(isapprox_array(fftsize, x1, x2, 1e-12));
+        CHECK(isapprox_array(fftsize, y1, y2, 1e-12));
+        destroy_fft(&fft1);
+        destroy_fft(&fft2);
+        CHECK(fft1 == NULL);
+        CHECK(fft2 == NULL);
+    }
+
+    SUBCASE("check clear: objects in use are not affected")
+    {
+        irfft_t* irfft = create_irfft(fftsize);
+        clear_fft_cache();
+        real_t re[fftsize / 2 + 1] = { 1.0 };
+        real_t im[fftsize / 2 + 1] = { 0.0 };
+        real_t y[fftsize];
+        execute_irfft(irfft, re, im, y);
+        for (size_t i = 0; i < fftsize; i++) {
+            CHECK(isapprox(y[i], 1.0 / fftsize, 1e-8));
+        }
+        destroy_irfft(&irfft);
+        clear_fft_cache();
+    }
+}
+
+TEST_CASE("FFT with scratch")
+{
+    const size_t fftsize = 64;
+    const size_t numbins = fftsize / 2 + 1;
+    fft_t* fft = create_fft(fftsize);
+    rfft_t* rfft = create_rfft(fftsize);
+    irfft_t* irfft = create_irfft(fftsize);
+    dct_t* dct = create_dct(fftsize);
+    size_t length = get_fft_scratch_length(fft);
+    length = MAX(length, get_fft_scratch_length(rfft));
+    length = MAX(length, get_fft_scratch_length(irfft));
+    length = MAX(length, get_fft_scratch_length(dct));
+
+    SUBCASE("check scratch: same results as the scratch of the object")
+    {
+        complex_t* scratch = allocate_fft_scratch(length);
+        real_t x1[fftsize], y1[fftsize], x2[fftsize], y2[fftsize];
+        for (size_t i = 0; i < fftsize; i++) {
+            x1[i] = x2[i] = sin(0.3 * i) + 0.1 * i;
+            y1[i] = y2[i] = cos(0.7 * i);
+        }
+        execute_fft(fft, x1, y1);
+        execute_fft_with_scratch(fft, x2, y2, scratch);
+        CHECK(isapprox_array(fftsize, x1, x2, 0.0));
+        CHECK(isapprox_array(fftsize, y1, y2, 0.0));
+
+        real_t re1[numbins], im1[numbins], re2[numbins], im2[numbins];
+        execute_rfft(rfft, x1, re1, im1);
+        execute_rfft_with_scratch(rfft, x1, re2, im2, scratch);
+        CHECK(isapprox_array(numbins, re1, re2, 0.0));
+        CHECK(isapprox_array(numbins, im1, im2, 0.0));
+        execute_irfft(irfft, re1, im1, y1);
+        execute_irfft_with_scratch(irfft, re2, im2, y2, scratch);
+        CHECK(isapprox_array(fftsize, y1, y2, 0.0));
+
+        execute_dct_inplace(dct, x1);
+        execute_dct_inplace_with_scratch(dct, x2, scratch);
+        CHECK(isapprox_array(numbins, x1, x2, 0.0));
+        free_fft_scratch(scratch);
+    }
+
+    SUBCASE("check threads: the same objects at once with their own scratch")
+    {
+        // spectrum and cepstrum of the sequence of each repetition
+        const size_t threads = 4, repeats = 50;
+        auto transform = [&](size_t index, complex_t* scratch, real_t* output) {
+            complex_t X[numbins];
+            real_t* x = (real_t*)X;
+            for (size_t i = 0; i < fftsize; i++) {
+                x[i] = sin(0.01 * (index + 1) * i);
+            }
+            execute_rfft_inplace_with_scratch(rfft, X, scratch);
+            for (size_t k = 0; k < numbins; k++) {
+                output[k] = log(X[k].re * X[k].re + X[k].im * X[k].im + 1e-12);
+            }
+            execute_dct_inplace_with_scratch(dct, output, scratch);
+        };
+
+        std::vector<real_t> expected(repeats * numbins), actual(threads * repeats * numbins);
+        complex_t* scratch = allocate_fft_scratch(length);
+        for (size_t r = 0; r < repeats; r++) {
+            transform(r, scratch, expected.data() + r * numbins);
+        }
+        free_fft_scratch(scratch);
+
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; t++) {
+            workers.emplace_back([&, t]() {
+                complex_t* scratch = allocate_fft_scratch(length);
+                for (size_t r = 0; r < repeats; r++) {
+                    transform(r, scratch, actual.data() + (t * repeats + r) * numbins);
+                }
+                free_fft_scratch(scratch);
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (size_t t = 0; t < threads; t++) {
+            CHECK(isapprox_array(repeats * numbins, actual.data() + t * repeats * numbins, expected.data(), 0.0));
+        }
+    }
+
+    destroy_fft(&fft);
+    destroy_rfft(&rfft);
+    destroy_irfft(&irfft);
+    destroy_dct(&dct);
+}
+
+TEST_CASE("FFT accuracy")
+{
+    // compared with the DFT in double precision
+#ifdef REIM_USE_FLOAT
+    const double tolerance = 1e-5;
+#else
+    const double tolerance = 1e-12;
+#endif
+    const size_t fftsize = 512;
+    const size_t numbins = fftsize / 2 + 1;
+    rfft_t* rfft = create_rfft(fftsize);
+    irfft_t* irfft = create_irfft(fftsize);
+    real_t x[fftsize], Xr[numbins], Xi[numbins], y[fftsize];
+    for (size_t i = 0; i < fftsize; i++) {
+        x[i] = sin(0.05 * i * i) + 0.5 * cos(0.3 * i);
+    }
+
+    SUBCASE("check RFFT: relative RMS error")
+    {
+        execute_rfft(rfft, x, Xr, Xi);
+        double error = 0.0, power = 0.0;
+        for (size_t k = 0; k < numbins; k++) {
+            double re = 0.0, im = 0.0;
+            for (size_t i = 0; i < fftsize; i++) {
+                const double omega = -2.0 * REIM_PI * (double)((i * k) % fftsize) / fftsize;
+                re += x[i] * cos(omega);
+                im += x[i] * sin(omega);
+            }
+            error += (Xr[k] - re) * (Xr[k] - re) + (Xi[k] - im) * (Xi[k] - im);
+            power += re * re + im * im;
+        }
+        CHECK(sqrt(error / power) < tolerance);
+    }
+
+    SUBCASE("check IRFFT: relative RMS error of the round trip")
+    {
+        execute_rfft(rfft, x, Xr, Xi);
+        execute_irfft(irfft, Xr, Xi, y);
+        double error = 0.0, power = 0.0;
+        for (size_t i = 0; i < fftsize; i++) {
+            error += (y[i] - x[i]) * (y[i] - x[i]);
+            power += (double)x[i] * x[i];
+        }
+        CHECK(sqrt(error / power) < tolerance);
+    }
+
+    destroy_rfft(&rfft);
+    destroy_irfft(&irfft);
+}
+
+TEST_CASE("FFT sizes")
+{
+#ifdef REIM_USE_FLOAT
+    const double tolerance = 1e-5;
+#else
+    const double tolerance = 1e-12;
+#endif
+
+    SUBCASE("check supported sizes")
+    {
+        CHECK(is_supported_fftsize(512));
+        CHECK(!is_supported_fftsize(0));
+        CHECK(!is_supported_fftsize(511));
+        CHECK(get_next_fftsize(512) == 512);
+        CHECK(get_next_fftsize(513) > 512);
+        CHECK(is_supported_fftsize(get_next_fftsize(2705)));
+    }
+
+    SUBCASE("check FFT/RFFT of mixed-radix sizes: relative RMS error")
+    {
+        // 2 * 3, 2^2 * 3 * 5, 2^3 * 3^2 * 5, 2^2 * 3 * 5^3 (not available with fftsg)
+        const size_t sizes[] = { 6, 60, 360, 1500 };
+        for (size_t n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++) {
+            const size_t fftsize = sizes[n];
+            if (!is_supported_fftsize(fftsize)) {
+                continue;
+            }
+            const size_t numbins = fftsize / 2 + 1;
+            fft_t* fft = create_fft(fftsize);
+            rfft_t* rfft = create_rfft(fftsize);
+            real_t x[1500], Xr[1500], Xi[1500];
+            for (size_t i = 0; i < fftsize; i++) {
+                x[i] = Xr[i] = sin(0.05 * i * i) + 0.5 * cos(0.3 * i);
+                Xi[i] = 0.0;
+            }
+            execute_fft(fft, Xr, Xi);
+            double error = 0.0, power = 0.0;
+            for (size_t k = 0; k < fftsize; k++) {
+                double re = 0.0, im = 0.0;
+                for (size_t i = 0; i < fftsize; i++) {
+                    const double omega = -2.0 * REIM_PI * (double)((i * k) % fftsize) / fftsize;
+                    re += x[i] * cos(omega);
+                    im += x[i] * sin(omega);
+                }
+                error += (Xr[k] - re) * (Xr[k] - re) + (Xi[k] - im) * (Xi[k] - im);
+                power += re * re + im * im;
+            }
+            CHECK(sqrt(error / power) < tolerance);
+
+            // the half spectrum is the same as the complex FFT
+            real_t Yr[751], Yi[751];
+            execute_rfft(rfft, x, Yr, Yi);
+            CHECK(isapprox_array(numbins, Yr, Xr, tolerance * fftsize));
+            CHECK(isapprox_array(numbins, Yi, Xi, tolerance * fftsize));
+
+            destroy_fft(&fft);
+            destroy_rfft(&rfft);
+        }
+    }
+}
+
+TEST_CASE("DCT and DST")
+{
+#ifdef REIM_USE_FLOAT
+    const double tolerance = 1e-5;
+#else
+    const double tolerance = 1e-12;
+#endif
+
+    SUBCASE("check DCT-I/DST-I: relative RMS error")
+    {
+        // n = fftsize / 2: 8, 256, 180, 15 (odd), 750 (not available with fftsg)
+        const size_t sizes[] = { 16, 512, 360, 30, 1500 };
+        for (size_t m = 0; m < sizeof(sizes) / sizeof(sizes[0]); m++) {
+            const size_t fftsize = sizes[m];
+            const size_t n = fftsize / 2;
+            dct_t* dct = create_dct(fftsize);
+            dst_t* dst = create_dst(fftsize);
+            if (dct == NULL || dst == NULL) {
+                CHECK(dct == dst);
+                continue;
+            }
+            real_t x[751], C[751], S[751];
+            for (size_t j = 0; j <= n; j++) {
+                x[j] = C[j] = S[j] = sin(0.05 * j * j) + 0.5 * cos(0.3 * j);
+            }
+            execute_dct_inplace(dct, C);
+            execute_dst_inplace(dst, S);
+
+            double error_c = 0.0, error_s = 0.0, power_c = 0.0, power_s = 0.0;
+            for (size_t k = 0; k <= n; k++) {
+                double c = x[0] + ((k % 2 == 0) ? x[n] : -x[n]);
+                double s = 0.0;
+                for (size_t j = 1; j < n; j++) {
+                    const double omega = REIM_PI * (double)((j * k) % fftsize) / n;
+                    c += 2.0 * x[j] * cos(omega);
+                    s += 2.0 * x[j] * sin(omega);
+                }
+                error_c += (C[k] - c) * (C[k] - c);
+                error_s += (S[k] - s) * (S[k] - s);
+                power_c += c * c;
+                power_s += s * s;
+            }
+            CHECK(sqrt(error_c / power_c) < tolerance);
+            CHECK(sqrt(error_s / power_s) < tolerance);
+            CHECK(S[0] == 0.0);
+            CHECK(S[n] == 0.0);
+
+            // self-inverse except for the scale of fftsize
+            execute_dct_inplace(dct, C);
+            execute_dst_inplace(dst, S);
+            for (size_t j = 0; j <= n; j++) {
+                CHECK(isapprox(C[j] / fftsize, x[j], tolerance * 10));
+            }
+            for (size_t j = 1; j < n; j++) {
+                CHECK(isapprox(S[j] / fftsize, x[j], tolerance * 10));
+            }
+
+            destroy_dct(&dct);
+            destroy_dst(&dst);
+        }
+    }
+
+    SUBCASE("check the smallest sizes")
+    {
+        CHECK(create_dct(2) == NULL);
+        CHECK(create_dst(2) == NULL);
+    }
+}
+
 // void check_fft()
 // {
 //     const int fftsize = 2048;
@@ -0,0 +1,170 @@
+#include "doctest.h"
+#include "reim/analyze_ap.h"
+#include "reim/analyze_fo.h"
+#include "reim/analyze_silence.h"
+#include "reim/analyze_sp.h"
+#include "reim/frame_analyzer.h"
+#include "reim/mathematics.h"
+#include "reim/memory.h"
+#include "reim/worker_pool.h"
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+namespace {
+
+void count_task(void* userdata, size_t index)
+{
+    size_t* counts = (size_t*)userdata;
+    counts[index]++;
+}
+
+// voiced (gliding harmonics), unvoiced (white noise) and silence
+std::vector<real_t> generate_frames_signal(double fs, size_t length)
+{
+    std::vector<real_t> x(length, 0.0);
+    uint32_t seed = 1;
+    double phase = 0.0;
+    for (size_t i = 0; i < length; i++) {
+        const double t = (double)i / length;
+        if (t < 0.4) {
+            const double fo = 120.0 + 200.0 * t;
+            phase += 2.0 * REIM_PI * fo / fs;
+            for (size_t h = 1; h * fo < fs / 2; h++) {
+                x[i] += (real_t)(0.3 * sin(h * phase) / h);
+            }
+        } else if (t < 0.75) {
+            seed = seed * 1664525u + 1013904223u;
+            x[i] = (real_t)(0.3 * ((seed >> 8) / 8388608.0 - 1.0));
+        }
+    }
+    return x;
+}
+
+}
+
+TEST_CASE("worker pool")
+{
+    const size_t max_count = 9;
+    size_t counts[max_count];
+
+    SUBCASE("check that every task runs once")
+    {
+        for (size_t num_workers = 0; num_workers <= 3; num_workers++) {
+            worker_pool_t* pool = create_worker_pool(num_workers);
+            REQUIRE(pool != NULL);
+            CHECK(pool->num_workers == num_workers);
+            for (size_t k = 0; k < max_count; k++) {
+                counts[k] = 0;
+            }
+
+            // jobs of 0 to max_count tasks
+            const size_t repeat = 200;
+            for (size_t r = 0; r < repeat; r++) {
+                for (size_t count = 0; count <= max_count; count++) {
+                    run_worker_pool(pool, count_task, counts, count);
+                }
+            }
+            for (size_t k = 0; k < max_count; k++) {
+                CHECK(counts[k] == repeat * (max_count - k));
+            }
+            destroy_worker_pool(&pool);
+            CHECK(pool == NULL);
+        }
+    }
+
+    SUBCASE("check the serial run without the pool")
+    {
+        for (size_t k = 0; k < max_count; k++) {
+            counts[k] = 0;
+        }
+        run_worker_pool(NULL, count_task, counts, max_count);
+        for (size_t k = 0; k < max_count; k++) {
+            CHECK(counts[k] == 1);
+        }
+    }
+}
+
+TEST_CASE("frame analyzer")
+{
+    const double fs = 16000;
+    const size_t fftsize = 1024;
+    const size_t hop = 80;
+    vocoder_context_t* vocoder = create_vocoder_context(5.0, fftsize, 71.0, 800.0, fs);
+    const size_t numbins = vocoder->numbins;
+    const std::vector<real_t> x = generate_frames_signal(fs, (size_t)fs);
+    std::vector<real_t> ap1(numbins), sp1(numbins), ap2(numbins), sp2(numbins);
+
+    // serial analysis (contexts 1) and the analyzer (contexts 2) with the same settings
+    fo_context_t* fo_context1 = NULL;
+    fo_context_t* fo_context2 = NULL;
+    sp_context_t* sp_context1 = NULL;
+    sp_context_t* sp_context2 = NULL;
+    bool logarithmic = false;
+
+    SUBCASE("DIO on each frame")
+    {
+        fo_context1 = create_fo_context(vocoder);
+        fo_context2 = create_fo_context(vocoder);
+        sp_context1 = create_sp_context(vocoder);
+        sp_context2 = create_sp_context(vocoder);
+    }
+
+    SUBCASE("decimated DIO, tabulated envelope in the log domain")
+    {
+        fo_context1 = create_fo_context_decimated(vocoder, 8000.0);
+        fo_context2 = create_fo_context_decimated(vocoder, 8000.0);
+        sp_context1 = create_sp_context_tabulated(vocoder, REIM_SP_TABLE_RESOLUTION);
+        sp_context2 = create_sp_context_tabulated(vocoder, REIM_SP_TABLE_RESOLUTION);
+        logarithmic = true;
+    }
+
+    ap_context_t* ap_context1 = create_ap_context(vocoder);
+    ap_context_t* ap_context2 = create_ap_context(vocoder);
+    frame_analyzer_t* analyzer = create_frame_analyzer(vocoder, fo_context2, ap_context2, sp_context2, 2);
+    REQUIRE(analyzer != NULL);
+
+    // the same results frame by frame, including the states carried over (e.g. the previous fo)
+    size_t num_voiced = 0, num_unvoiced = 0, num_silence = 0;
+    bool is_all_matched = true;
+    for (size_t position = 0; position + fftsize + 1 <= x.size(); position += hop) {
+        const real_t* waveform = x.data() + position + 1;
+        const real_t* waveform_delayed = x.data() + position;
+
+        const bool issilence = analyze_silence(vocoder, waveform, REIM_SILENCE_THRESHOLD);
+        const double fo = analyze_fo(vocoder, fo_context1, waveform, waveform_delayed);
+        const bool isvoiced = analyze_ap(vocoder, ap_context1, waveform, fo, issilence, ap1.data());
+        if (logarithmic) {
+            analyze_sp_log(vocoder, sp_context1, waveform, fo, isvoiced, issilence, sp1.data());
+            analyze_frame_log(analyzer, waveform, waveform_delayed, ap2.data(), sp2.data());
+        } else {
+            analyze_sp(vocoder, sp_context1, waveform, fo, isvoiced, issilence, sp1.data());
+            analyze_frame(analyzer, waveform, waveform_delayed, ap2.data(), sp2.data());
+        }
+
+        is_all_matched &= (analyzer->issilence == issilence);
+        is_all_matched &= (analyzer->fo == fo);
+        is_all_matched &= (analyzer->isvoiced == isvoiced);
+        for (size_t k = 0; k < numbins; k++) {
+            is_all_matched &= (ap2[k] == ap1[k]);
+            is_all_matched &= (sp2[k] == sp1[k]);
+        }
+        num_silence += issilence ? 1 : 0;
+        num_voiced += (!issilence && isvoiced) ? 1 : 0;
+        num_unvoiced += (!issilence && !isvoiced) ? 1 : 0;
+    }
+    CHECK(is_all_matched);
+    CHECK(num_voiced > 0);
+    CHECK(num_unvoiced > 0);
+    CHECK(num_silence > 0);
+
+    destroy_frame_analyzer(&analyzer);
+    CHECK(analyzer == NULL);
+    destroy_ap_context(&ap_context2);
+    destroy_ap_context(&ap_context1);
+    destroy_sp_context(&sp_context2);
+    destroy_sp_context(&sp_context1);
+    destroy_fo_context(&fo_context2);
+    destroy_fo_context(&fo_context1);
+    destroy_vocoder_context(&vocoder);
+}
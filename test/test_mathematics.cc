@@ -69,6 +69,16 @@ TEST_CASE("ispow2")
     }
 }
 
+TEST_CASE("next pow2")
+{
+    CHECK(get_next_pow2(0) == 1);
+    CHECK(get_next_pow2(1) == 1);
+    CHECK(get_next_pow2(2) == 2);
+    CHECK(get_next_pow2(3) == 4);
+    CHECK(get_next_pow2(4) == 4);
+    CHECK(get_next_pow2(2049) == 4096);
+}
+
 TEST_CASE("abs2")
 {
     CHECK(COMPLEX_ABS2(0, 0) == 0);
@@ -104,8 +114,8 @@ TEST_CASE("instfreq")
 
 TEST_CASE("ifftshift")
 {
-    double src[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
-    double dst[8] = { 9, 9, 9, 9, 9, 9, 9, 9 };
+    real_t src[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    real_t dst[8] = { 9, 9, 9, 9, 9, 9, 9, 9 };
     ifftshift(src, dst, 5);
     CHECK(dst[0] == 5);
     CHECK(dst[1] == 6);
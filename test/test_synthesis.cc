@@ -0,0 +1,368 @@
+#include "doctest.h"
+#include "reim/audio_frame.h"
+#include "reim/fft.h"
+#include "reim/mathematics.h"
+#include "reim/memory.h"
+#include "reim/synthesis.h"
+#include "reim/vocoder.h"
+#include <math.h>
+#include <vector>
+
+namespace {
+
+// energy of the Hann-windowed signal above the frequency (in dB relative to the energy of the reference)
+double band_energy_ratio(const real_t* reference, const real_t* signal, size_t length, double fs, double freq_min)
+{
+    rfft_t* rfft = create_rfft(length);
+    real_t* x = allocate_vector(length);
+    real_t* re = allocate_vector(length / 2 + 1);
+    real_t* im = allocate_vector(length / 2 + 1);
+
+    double energy[2] = { 0.0, 0.0 };
+    const real_t* inputs[2] = { reference, signal };
+    for (size_t n = 0; n < 2; n++) {
+        for (size_t i = 0; i < length; i++) {
+            x[i] = inputs[n][i] * (0.5 - 0.5 * cos(2.0 * REIM_PI * i / length));
+        }
+        execute_rfft(rfft, x, re, im);
+        for (size_t k = (size_t)ceil(freq_min * length / fs); k <= length / 2; k++) {
+            energy[n] += re[k] * re[k] + im[k] * im[k];
+        }
+    }
+
+    free_vector(im);
+    free_vector(re);
+    free_vector(x);
+    destroy_rfft(&rfft);
+    return 10.0 * log10(energy[1] / energy[0]);
+}
+
+// Exact minimum phase filter of the power spectrum by the complex FFT (the causal part of the real cepstrum)
+std::vector<complex_t> generate_minimum_phase_reference(const std::vector<double>& power, size_t fftsize, double gain)
+{
+    const size_t numbins = fftsize / 2 + 1;
+    fft_t* fft = create_fft(fftsize);
+    ifft_t* ifft = create_ifft(fftsize);
+    std::vector<complex_t> data(fftsize);
+
+    // real cepstrum of the log amplitude
+    for (size_t k = 0; k < fftsize; k++) {
+        data[k].re = (real_t)(0.5 * log(power[(k < numbins) ? k : fftsize - k]));
+        data[k].im = 0.0;
+    }
+    execute_ifft_inplace(ifft, data.data());
+
+    // causal part
+    for (size_t n = 0; n < fftsize; n++) {
+        const double scale = (n == 0 || n == fftsize / 2) ? 1.0 : (n < fftsize / 2) ? 2.0 : 0.0;
+        data[n].re = (real_t)(data[n].re * scale / fftsize);
+        data[n].im = 0.0;
+    }
+    execute_fft_inplace(fft, data.data());
+
+    std::vector<complex_t> spec(numbins);
+    for (size_t k = 0; k < numbins; k++) {
+        const double magnitude = gain * exp(data[k].re);
+        spec[k].re = (real_t)(magnitude * cos(data[k].im));
+        spec[k].im = (real_t)(magnitude * sin(data[k].im));
+    }
+    destroy_ifft(&ifft);
+    destroy_fft(&fft);
+    return spec;
+}
+
+// Error of the spectrum relative to the reference (in dB)
+double spectrum_error(const complex_t* spec, const std::vector<complex_t>& reference)
+{
+    double energy = 0.0, error = 0.0;
+    for (size_t k = 0; k < reference.size(); k++) {
+        const double dr = spec[k].re - reference[k].re;
+        const double di = spec[k].im - reference[k].im;
+        energy += reference[k].re * reference[k].re + reference[k].im * reference[k].im;
+        error += dr * dr + di * di;
+    }
+    return 10.0 * log10(error / energy + 1e-40);
+}
+
+// Synthesize the frames at the hops of audio_frame_t (voiced, unvoiced or silent by the frame index)
+std::vector<real_t> synthesize_frames(vocoder_context_t* vocoder, synthesis_context_t* context, size_t length,
+    const real_t* ap, const real_t* sp)
+{
+    audio_frame_t* frame = create_audio_frame(vocoder->fs, vocoder->period, vocoder->fftsize);
+    const std::vector<real_t> input(length, 0.0);
+    std::vector<real_t> output(length);
+    size_t position = 0, index = 0;
+    while (position < length) {
+        bool has_new_frame = false;
+        const size_t count = next_audio_frame_block(frame, input.data() + position, length - position, &has_new_frame);
+        synthesize_block(vocoder, context, output.data() + position, count - 1);
+        if (has_new_frame) {
+            const size_t phase = index % 40;
+            const bool issilence = (phase >= 12 && phase < 15) || phase == 30;
+            const bool isvoiced = (phase < 20);
+            synthesize_new_frame(vocoder, context, 150.0 + 0.5 * phase, isvoiced, issilence, ap, sp);
+            index++;
+        }
+        synthesize_block(vocoder, context, output.data() + position + count - 1, 1);
+        position += count;
+    }
+    destroy_audio_frame(&frame);
+    return output;
+}
+
+}
+
+TEST_CASE("synthesis with the block noise")
+{
+    // 44.1 kHz: the frame period of 220.5 samples (the hops alternate between 220 and 221),
+    // 96 kHz with the short FFT: the frames longer than the span of the block rendering (fftsize / 4)
+    // The error is the tail of the filter wrapped around the FFT size, which is longer for the shorter FFT size.
+    const double fs_list[] = { 44100, 48000, 96000 };
+    const size_t fftsize_list[] = { 2048, 2048, 1024 };
+    const double snr_list[] = { 75.0, 75.0, 60.0 };
+    for (size_t n = 0; n < 3; n++) {
+        const double fs = fs_list[n];
+        const size_t fftsize = fftsize_list[n];
+        vocoder_context_t* vocoder = create_vocoder_context(5.0, fftsize, 60.0, 600.0, fs);
+        std::vector<real_t> sp(vocoder->numbins), ap(vocoder->numbins);
+        for (size_t k = 0; k < vocoder->numbins; k++) {
+            const double freq = k * fs / fftsize;
+            const double formant = (freq - 800.0) / 300.0;
+            sp[k] = 1e-4 + exp(-0.5 * formant * formant) + 0.1 * exp(-freq / 3000.0);
+            ap[k] = 0.1 + 0.8 * freq / (fs / 2);
+        }
+
+        // the same random sequence, and the same filters (the responses are not truncated)
+        synthesis_context_t* context = create_synthesis_context(vocoder);
+        synthesis_context_t* context_block = create_synthesis_context_block_noise(vocoder);
+        const size_t length = (size_t)(2 * fs);
+        const std::vector<real_t> y = synthesize_frames(vocoder, context, length, ap.data(), sp.data());
+        const std::vector<real_t> y_block = synthesize_frames(vocoder, context_block, length, ap.data(), sp.data());
+
+        double energy = 0.0, error = 0.0;
+        for (size_t i = 0; i < length; i++) {
+            const double diff = y_block[i] - y[i];
+            energy += y[i] * y[i];
+            error += diff * diff;
+        }
+        const double snr = 10.0 * log10(energy / error);
+        MESSAGE("SNR of the block noise: " << snr << " dB (" << fs << " Hz, fftsize " << fftsize << ")");
+        CHECK(snr > snr_list[n]);
+
+        destroy_synthesis_context(&context_block);
+        destroy_synthesis_context(&context);
+        destroy_vocoder_context(&vocoder);
+    }
+}
+
+TEST_CASE("synthesis")
+{
+    const double fs = 16000;
+    const double period = 5.0; // 80 samples
+    const size_t fftsize = 1024;
+    const size_t hopsize = 80;
+    const size_t count = 72;
+    const size_t length = count * hopsize;
+    vocoder_context_t* vocoder = create_vocoder_context(period, fftsize, 60.0, 600.0, fs);
+
+    // power spectrum with a formant at 500 Hz, aperiodicity rising with the frequency
+    real_t* sp = allocate_vector(vocoder->numbins);
+    real_t* ap = allocate_vector(vocoder->numbins);
+    for (size_t k = 0; k < vocoder->numbins; k++) {
+        const double freq = k * fs / fftsize;
+        const double formant = (freq - 500.0) / 200.0;
+        sp[k] = 1e-4 + exp(-0.5 * formant * formant) + 0.1 * exp(-freq / 2000.0);
+        ap[k] = 0.1 + 0.8 * freq / (fs / 2);
+    }
+
+    SUBCASE("check the noise floor of the truncated impulse responses")
+    {
+        synthesis_context_t* context_full = create_synthesis_context(vocoder);
+        synthesis_context_t* context_trunc = create_synthesis_context(vocoder);
+        CHECK(context_full->tolerance == 0.0);
+        context_trunc->tolerance = REIM_IMPULSE_TOLERANCE;
+
+        real_t* y_full = allocate_vector(length);
+        real_t* y_trunc = allocate_vector(length);
+        real_t* error = allocate_vector(length);
+        for (size_t m = 0; m < count; m++) {
+            // voiced frames with the gliding fo, then unvoiced frames
+            const double fo = 120.0 + 2.0 * m;
+            const bool isvoiced = (m < count / 2);
+            synthesize_new_frame(vocoder, context_full, fo, isvoiced, false, ap, sp);
+            synthesize_new_frame(vocoder, context_trunc, fo, isvoiced, false, ap, sp);
+            synthesize_block(vocoder, context_full, y_full + m * hopsize, hopsize);
+            synthesize_block(vocoder, context_trunc, y_trunc + m * hopsize, hopsize);
+        }
+
+        // the full responses are written without the truncation
+        CHECK(context_full->support_noise.offset == 0);
+        CHECK(context_full->support_noise.length == fftsize);
+        CHECK(context_trunc->support_noise.length < fftsize);
+
+        // noise floor above 100 Hz (the residual of the DC removal is in the lower band)
+        const size_t analysis_length = 2048;
+        const size_t offset_voiced = 512;
+        const size_t offset_unvoiced = count / 2 * hopsize + 320;
+        for (size_t i = 0; i < length; i++) {
+            error[i] = y_trunc[i] - y_full[i];
+        }
+        const double floor_voiced = band_energy_ratio(y_full + offset_voiced, error + offset_voiced, analysis_length, fs, 100.0);
+        const double floor_unvoiced = band_energy_ratio(y_full + offset_unvoiced, error + offset_unvoiced, analysis_length, fs, 100.0);
+        MESSAGE("noise floor of the truncation above 100 Hz: " << floor_voiced << " dB (voiced), " << floor_unvoiced << " dB (unvoiced)");
+        CHECK(floor_voiced < -40.0);
+        CHECK(floor_unvoiced < -40.0);
+
+        // noise floor over the full band (the residual of the DC removal dominates on the unvoiced frames)
+        const double snr_voiced = band_energy_ratio(y_full + offset_voiced, error + offset_voiced, analysis_length, fs, 0.0);
+        const double snr_unvoiced = band_energy_ratio(y_full + offset_unvoiced, error + offset_unvoiced, analysis_length, fs, 0.0);
+        MESSAGE("noise floor of the truncation over the full band: " << snr_voiced << " dB (voiced), " << snr_unvoiced << " dB (unvoiced)");
+        CHECK(snr_voiced < -45.0);
+        CHECK(snr_unvoiced < -30.0);
+
+        free_vector(error);
+        free_vector(y_trunc);
+        free_vector(y_full);
+        destroy_synthesis_context(&context_trunc);
+        destroy_synthesis_context(&context_full);
+    }
+
+    SUBCASE("check the fractional delay of the pulses against the exact phase ramp")
+    {
+        synthesis_context_t* context = create_synthesis_context(vocoder);
+        synthesize_new_frame(vocoder, context, 150.0, true, false, ap, sp);
+
+        const size_t numbins = vocoder->numbins;
+        irfft_t* irfft = create_irfft(fftsize);
+        complex_t* spec = REIM_ALLOC(numbins, complex_t);
+        real_t* expected = allocate_vector(fftsize);
+        double worst = -400.0;
+        for (size_t i = 0; i <= 40; i++) {
+            // a pulse delayed by the fraction of the sample
+            const double shift = i / 40.0 * 0.99;
+            context->pulse_int = 0;
+            context->pulse_frc = shift;
+            synthesize_next_sample(vocoder, context);
+            REQUIRE(context->support_pulse.length == fftsize);
+
+            // exact delay: the phase ramp on the spectrum of the filter, then the same DC removal
+            for (size_t k = 0; k < numbins; k++) {
+                const double omega = -2.0 * REIM_PI * shift * k / fftsize;
+                const double xr = context->spec_pulse[k].re / fftsize;
+                const double xi = context->spec_pulse[k].im / fftsize;
+                spec[k].re = (real_t)(xr * cos(omega) - xi * sin(omega));
+                spec[k].im = (real_t)(xr * sin(omega) + xi * cos(omega));
+            }
+            execute_irfft_inplace(irfft, spec);
+            ifftshift((const real_t*)spec, expected, numbins);
+            double gain = 0.0;
+            for (size_t n = 0; n < fftsize; n++) {
+                gain += expected[n];
+            }
+            double energy = 0.0, error = 0.0;
+            for (size_t n = 0; n < fftsize; n++) {
+                expected[n] -= (real_t)(context->support_pulse.window[n] * gain);
+                const double diff = context->impulse_pulse[n] - expected[n];
+                energy += expected[n] * expected[n];
+                error += diff * diff;
+            }
+            const double error_db = 10.0 * log10(error / energy + 1e-40);
+            worst = MAX(worst, error_db);
+            if (i == 0) {
+                CHECK(error_db < -100.0); // the center tap only
+            }
+        }
+        MESSAGE("error of the fractional delay: " << worst << " dB (worst)");
+        CHECK(worst < -36.0);
+
+        free_vector(expected);
+        REIM_FREE(spec);
+        destroy_irfft(&irfft);
+        destroy_synthesis_context(&context);
+    }
+
+    SUBCASE("check the synthesis from the log envelope against the envelope")
+    {
+        synthesis_context_t* context = create_synthesis_context(vocoder);
+        synthesis_context_t* context_log = create_synthesis_context(vocoder);
+        real_t* sp_log = allocate_vector(vocoder->numbins);
+        for (size_t k = 0; k < vocoder->numbins; k++) {
+            sp_log[k] = (real_t)log(sp[k]);
+        }
+
+        real_t* y = allocate_vector(length);
+        real_t* y_log = allocate_vector(length);
+        for (size_t m = 0; m < count; m++) {
+            // voiced, unvoiced and silent frames
+            const double fo = 120.0 + 2.0 * m;
+            const bool isvoiced = (m < count / 2);
+            const bool issilence = (m % 12 == 11);
+            synthesize_new_frame(vocoder, context, fo, isvoiced, issilence, ap, sp);
+            synthesize_new_frame_log(vocoder, context_log, fo, isvoiced, issilence, ap, sp_log);
+            synthesize_block(vocoder, context, y + m * hopsize, hopsize);
+            synthesize_block(vocoder, context_log, y_log + m * hopsize, hopsize);
+        }
+
+        double energy = 0.0, error = 0.0;
+        for (size_t i = 0; i < length; i++) {
+            const double diff = y_log[i] - y[i];
+            energy += y[i] * y[i];
+            error += diff * diff;
+        }
+        const double error_db = 10.0 * log10(error / energy + 1e-40);
+        MESSAGE("error of the synthesis from the log envelope: " << error_db << " dB");
+#ifdef REIM_USE_FLOAT
+        CHECK(error_db < -100.0);
+#else
+        CHECK(error_db < -180.0);
+#endif
+
+        free_vector(y_log);
+        free_vector(y);
+        free_vector(sp_log);
+        destroy_synthesis_context(&context_log);
+        destroy_synthesis_context(&context);
+    }
+
+    SUBCASE("check the pulse and noise filters against the exact minimum phase filters of the components")
+    {
+        synthesis_context_t* context = create_synthesis_context(vocoder);
+        const size_t numbins = vocoder->numbins;
+        const double fo = 150.0;
+        real_t* ap_test = allocate_vector(numbins);
+        std::vector<double> power(numbins);
+
+        // 0: rising linearly (the subcases above), 1: a sigmoid around 3 kHz, 2: flat
+        const double bounds[] = { -40.0, -40.0, -80.0 };
+        for (size_t n = 0; n < 3; n++) {
+            for (size_t k = 0; k < numbins; k++) {
+                const double freq = k * fs / fftsize;
+                ap_test[k] = (n == 0) ? ap[k] : (n == 1) ? 0.05 + 0.9 / (1.0 + exp(-(freq - 3000.0) / 500.0)) : 0.3;
+            }
+            synthesize_new_frame(vocoder, context, fo, true, false, ap_test, sp);
+
+            // the filters of sp * (1 - ap^2) and sp * ap^2
+            for (size_t k = 0; k < numbins; k++) {
+                power[k] = sp[k] * (1.0 - ap_test[k] * ap_test[k]) + 1e-12;
+            }
+            const std::vector<complex_t> pulse = generate_minimum_phase_reference(power, fftsize, sqrt(fs / fo));
+            for (size_t k = 0; k < numbins; k++) {
+                power[k] = sp[k] * ap_test[k] * ap_test[k] + 1e-12;
+            }
+            const std::vector<complex_t> noise = generate_minimum_phase_reference(power, fftsize, context->gain_noise);
+
+            const double error_pulse = spectrum_error(context->spec_pulse, pulse);
+            const double error_noise = spectrum_error(context->spec_noise, noise);
+            MESSAGE("error of the filters (ap " << n << "): " << error_pulse << " dB (pulse), " << error_noise << " dB (noise)");
+            CHECK(error_pulse < bounds[n]);
+            CHECK(error_noise < bounds[n]);
+        }
+
+        free_vector(ap_test);
+        destroy_synthesis_context(&context);
+    }
+
+    free_vector(ap);
+    free_vector(sp);
+    destroy_vocoder_context(&vocoder);
+}
@@ -0,0 +1,135 @@
+#include "doctest.h"
+#include "reim/mathematics.h"
+#include "reim/vmath.h"
+#include <stdio.h>
+#include <vector>
+
+namespace {
+
+#ifdef REIM_USE_FLOAT
+const double vmath_eta = 4e-7;
+#else
+const double vmath_eta = 1e-15;
+#endif
+
+// relative error with the absolute floor of 1
+double vmath_error(double a, double b)
+{
+    const double diff = (a > b) ? a - b : b - a;
+    const double scale = (b > 0) ? b : -b;
+    return diff / ((scale > 1.0) ? scale : 1.0);
+}
+
+// n points over [a, b] (the odd length leaves the tail for the vector kernels)
+std::vector<real_t> vmath_range(double a, double b, size_t n)
+{
+    std::vector<real_t> x(n);
+    for (size_t i = 0; i < n; i++) {
+        x[i] = (real_t)(a + (b - a) * i / (n - 1));
+    }
+    return x;
+}
+
+}
+
+TEST_CASE("vmath information")
+{
+    printf("Current vmath kernel: %s\n", get_vmath_kernel_name());
+}
+
+TEST_CASE("vmath")
+{
+    const size_t n = 4099;
+
+    SUBCASE("check vlog")
+    {
+        std::vector<real_t> x = vmath_range(-80.0, 80.0, n), y(n);
+        for (size_t i = 0; i < n; i++) {
+            x[i] = (real_t)exp(x[i]);
+        }
+        vlog(x.data(), y.data(), n);
+        double error = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            error = MAX(error, vmath_error(y[i], log((double)x[i])));
+        }
+        CHECK(error < vmath_eta);
+    }
+
+    SUBCASE("check vexp")
+    {
+        std::vector<real_t> x = vmath_range(-80.0, 80.0, n), y(n);
+        vexp(x.data(), y.data(), n);
+        double error = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            const double expected = exp((double)x[i]);
+            error = MAX(error, vmath_error(y[i] / expected, 1.0));
+        }
+        CHECK(error < vmath_eta);
+    }
+
+    SUBCASE("check vsincos")
+    {
+        std::vector<real_t> x = vmath_range(-1000.0, 1000.0, n), s(n), c(n);
+        vsincos(x.data(), s.data(), c.data(), n);
+        double error = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            error = MAX(error, vmath_error(s[i], sin((double)x[i])));
+            error = MAX(error, vmath_error(c[i], cos((double)x[i])));
+        }
+        CHECK(error < vmath_eta);
+    }
+
+    SUBCASE("check vatan2")
+    {
+        std::vector<real_t> phase = vmath_range(-REIM_PI, REIM_PI, n), x(n), y(n), angle(n);
+        for (size_t i = 0; i < n; i++) {
+            const double radius = 1e-3 + i;
+            x[i] = (real_t)(radius * cos(phase[i]));
+            y[i] = (real_t)(radius * sin(phase[i]));
+        }
+        vatan2(y.data(), x.data(), angle.data(), n);
+        double error = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            error = MAX(error, vmath_error(angle[i], atan2((double)y[i], (double)x[i])));
+        }
+        CHECK(error < vmath_eta);
+
+        real_t zeros[2] = { 0.0, 0.0 };
+        vatan2(zeros, zeros, angle.data(), 2);
+        CHECK(angle[0] == 0.0);
+    }
+
+    SUBCASE("check vabs2")
+    {
+        std::vector<real_t> re = vmath_range(-3.0, 3.0, n), im = vmath_range(2.0, -5.0, n), y(n);
+        std::vector<complex_t> x(n);
+        for (size_t i = 0; i < n; i++) {
+            x[i].re = re[i];
+            x[i].im = im[i];
+        }
+        vabs2(x.data(), y.data(), n);
+        double error = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            error = MAX(error, vmath_error(y[i], (double)re[i] * re[i] + (double)im[i] * im[i]));
+        }
+        CHECK(error < vmath_eta);
+    }
+
+    SUBCASE("check in-place and the tail")
+    {
+        // every element gives the same result regardless of the length and the position
+        std::vector<real_t> x = vmath_range(-5.0, 5.0, n), y(n), s(n), c(n);
+        vexp(x.data(), y.data(), n);
+        vsincos(x.data(), s.data(), c.data(), n);
+        for (size_t length = 1; length <= 17; length++) {
+            std::vector<real_t> z(x.begin() + 1, x.begin() + 1 + length), zs(length), zc(length);
+            vsincos(z.data(), zs.data(), zc.data(), length);
+            vexp(z.data(), z.data(), length);
+            bool is_all_matched = true;
+            for (size_t i = 0; i < length; i++) {
+                is_all_matched &= (z[i] == y[i + 1]) && (zs[i] == s[i + 1]) && (zc[i] == c[i + 1]);
+            }
+            CHECK(is_all_matched);
+        }
+    }
+}